@@ -42,6 +42,9 @@ const juce::Rectangle<int> kPresetTextRef { 2458, 566, 432, 58 };
 const juce::Rectangle<int> kPresetOpenRef { 2438, 533, 470, 126 };
 const juce::Rectangle<int> kPresetPrevRef { 2888, 552, 64, 38 };
 const juce::Rectangle<int> kPresetNextRef { 2888, 596, 64, 38 };
+const juce::Rectangle<int> kSnapshotSlotsRef { 2438, 470, 470, 52 }; // A/B/C/D compare slots and Save above the preset bar
+const juce::Rectangle<int> kCabinetRef       { 2438, 404, 470, 56 }; // cabinet type, mix and IR loader above the slots
+const juce::Rectangle<int> kMorphRef         { 2438, 340, 470, 56 }; // morph ends A/B, position and release
 const juce::Rectangle<int> kLeftFaderRef  { 120, 201, 81, 1530 };
 const juce::Rectangle<int> kRightFaderRef { 3065, 204, 81, 1530 };
 const juce::Rectangle<int> kLeftFaderCutoutRef  { 135, 217, 55, 1492 };
@@ -144,15 +147,6 @@ constexpr float kSideFaderKnobTopSize = 77.782f;
 constexpr float kSmallFaderKnobOuterSize = 56.0f;
 constexpr float kSmallFaderKnobTopSize = 40.0f;
 
-juce::String sanitisePresetDisplayName(juce::String name)
-{
-    name = name.trim();
-    while (name.contains("  "))
-        name = name.replace("  ", " ");
-    name = name.replace("_", " ");
-    return name.trim();
-}
-
 static void fillChassisBlendPatch(juce::Graphics& g,
                                   juce::Rectangle<float> area,
                                   float designScreenTop,
@@ -217,65 +211,6 @@ static void fillChassisBlendPatch(juce::Graphics& g,
     g.drawEllipse(area.reduced(1.0f), 0.45f);
 }
 
-juce::String stripPresetOrderingPrefix(juce::String name)
-{
-    name = sanitisePresetDisplayName(name);
-
-    int index = 0;
-    while (index < name.length() && juce::CharacterFunctions::isDigit(name[index]))
-        ++index;
-
-    if (index > 0)
-    {
-        while (index < name.length() && (name[index] == ' ' || name[index] == '-' || name[index] == '_'))
-            ++index;
-        name = name.substring(index).trim();
-    }
-
-    return sanitisePresetDisplayName(name);
-}
-
-juce::String normaliseCategoryFolderName(juce::String folderName)
-{
-    folderName = sanitisePresetDisplayName(folderName);
-    if (folderName.equalsIgnoreCase("Keys Synth")
-        || folderName.equalsIgnoreCase("Keys / Synth")
-        || folderName.equalsIgnoreCase("Keys _ Synth"))
-        return "Keys / Synth";
-    return folderName;
-}
-
-juce::String makePresetKey(const juce::String& category, const juce::String& preset)
-{
-    auto key = (normaliseCategoryFolderName(category) + "|" + sanitisePresetDisplayName(preset)).toLowerCase();
-    key = key.removeCharacters(" .,_'!-+()/\\");
-    return key;
-}
-
-juce::File findPresetImageRoot()
-{
-    juce::Array<juce::File> roots;
-    roots.add(juce::File::getCurrentWorkingDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory());
-
-    for (const auto& root : roots)
-    {
-        auto dir = root;
-        for (int d = 0; d < 6; ++d)
-        {
-            const auto candidate = dir.getChildFile("Unison Mod PRESETS");
-            if (candidate.isDirectory())
-                return candidate;
-            if (dir.isRoot())
-                break;
-            dir = dir.getParentDirectory();
-        }
-    }
-
-    return {};
-}
-
 // LookAndFeel that draws NOTHING for linear sliders —
 // all visual rendering is done in the editor's own paint() via drawSideFaderHandles etc.
 struct NoThumbLAF : public juce::LookAndFeel_V4
@@ -310,6 +245,26 @@ struct NoThumbLAF : public juce::LookAndFeel_V4
 };
 static NoThumbLAF gNoThumbLAF;
 
+// Forwards one parameter's changes to the editor's change bus. Called on
+// whichever thread changed the parameter, so it only sets a bit.
+// Changes made by a bulk state restore are skipped; the restore is picked up
+// once through the processor's state generation instead.
+struct ChangeBusListener : public juce::AudioProcessorValueTreeState::Listener
+{
+    ChangeBusListener(const ThreeVoicesAudioProcessor& p, ParameterChangeBus& b, ParamIds::Index i)
+        : processor(p), bus(b), index(i) {}
+
+    void parameterChanged(const juce::String&, float) override
+    {
+        if (!processor.isRestoringState())
+            bus.markDirty(index);
+    }
+
+    const ThreeVoicesAudioProcessor& processor;
+    ParameterChangeBus& bus;
+    ParamIds::Index index;
+};
+
 } // namespace
 
 // ============================================================================
@@ -320,6 +275,7 @@ ThreeVoicesAudioProcessorEditor::ThreeVoicesAudioProcessorEditor(ThreeVoicesAudi
     DBG("Exe path: " + juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName());
     setOpaque(true);
     setResizable(false, false);
+    setWantsKeyboardFocus(true);
 
     loadImages();
     initialiseControls();
@@ -334,7 +290,6 @@ ThreeVoicesAudioProcessorEditor::ThreeVoicesAudioProcessorEditor(ThreeVoicesAudi
     outputGainSlider.setVisible(false);
 
     initialiseScreenAnimation();
-    buildPresetPreviewLibrary();
 
     addAndMakeVisible(presetButton);
     addAndMakeVisible(previousPresetButton);
@@ -346,20 +301,101 @@ ThreeVoicesAudioProcessorEditor::ThreeVoicesAudioProcessorEditor(ThreeVoicesAudi
     previousPresetButton.onClick = [this] { stepPreset(-1); };
     nextPresetButton.onClick = [this] { stepPreset(1); };
 
-    for (const auto* id : kVoiceIds)      audioProcessor.getAPVTS().addParameterListener(id, this);
-    for (const auto* id : kBitIds)        audioProcessor.getAPVTS().addParameterListener(id, this);
-    for (const auto* id : kTubeIds)       audioProcessor.getAPVTS().addParameterListener(id, this);
-    audioProcessor.getAPVTS().addParameterListener("presetChoice", this);
-    audioProcessor.getAPVTS().addParameterListener("inputGain",    this);
-    audioProcessor.getAPVTS().addParameterListener("outputGain",   this);
-    audioProcessor.getAPVTS().addParameterListener("width",        this);
-    audioProcessor.getAPVTS().addParameterListener("mix",          this);
-    for (const auto* id : kSpeedIds)      audioProcessor.getAPVTS().addParameterListener(id, this);
-    for (const auto* id : kDelayIds)      audioProcessor.getAPVTS().addParameterListener(id, this);
-    for (const auto* id : kDepthIds)      audioProcessor.getAPVTS().addParameterListener(id, this);
-    for (const auto* id : kDistortionIds) audioProcessor.getAPVTS().addParameterListener(id, this);
+    for (int i = 0; i < (int) snapshotSlotButtons.size(); ++i)
+    {
+        auto& button = snapshotSlotButtons[(size_t) i];
+        button.setButtonText(juce::String::charToString((juce::juce_wchar) ('A' + i)));
+        button.setLookAndFeel(&unisonLookAndFeel);
+        button.setColour(juce::TextButton::buttonColourId,   juce::Colour(0xFFB8B9BB));
+        button.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xFF47B96C));
+        button.setColour(juce::TextButton::textColourOffId,  juce::Colour(0xFF3A3A3C));
+        button.setColour(juce::TextButton::textColourOnId,   juce::Colours::white);
+        button.onClick = [this, i]
+        {
+            audioProcessor.selectSnapshotSlot(i);
+            updateSnapshotSlotButtons();
+        };
+        addAndMakeVisible(button);
+    }
+    updateSnapshotSlotButtons();
+
+    savePresetButton.setButtonText("Save");
+    savePresetButton.setTooltip("Save the current sound as a user preset");
+    savePresetButton.setLookAndFeel(&unisonLookAndFeel);
+    savePresetButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xFFB8B9BB));
+    savePresetButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xFF3A3A3C));
+    savePresetButton.onClick = [this] { showSavePresetWindow(); };
+    addAndMakeVisible(savePresetButton);
+
+    cabinetTypeBox.setLookAndFeel(&unisonLookAndFeel);
+    cabinetTypeBox.setTooltip("Cabinet");
+    addAndMakeVisible(cabinetTypeBox);
+
+    cabinetMixSlider.setLookAndFeel(&unisonLookAndFeel);
+    cabinetMixSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    cabinetMixSlider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    cabinetMixSlider.setPopupDisplayEnabled(true, true, this);
+    cabinetMixSlider.setTooltip("Cabinet Mix");
+    addAndMakeVisible(cabinetMixSlider);
+
+    cabinetLoadButton.setButtonText("IR...");
+    cabinetLoadButton.setLookAndFeel(&unisonLookAndFeel);
+    cabinetLoadButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xFFB8B9BB));
+    cabinetLoadButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xFF3A3A3C));
+    cabinetLoadButton.onClick = [this] { chooseCabinetImpulse(); };
+    addAndMakeVisible(cabinetLoadButton);
+    updateCabinetLoadButton();
+
+    for (int end = 0; end < 2; ++end)
+    {
+        auto& button = morphEndButtons[end];
+        button.setButtonText(end == 0 ? "A" : "B");
+        button.setTooltip(end == 0 ? "Store the current sound as morph end A" : "Store the current sound as morph end B");
+        button.setLookAndFeel(&unisonLookAndFeel);
+        button.setColour(juce::TextButton::buttonColourId,   juce::Colour(0xFFB8B9BB));
+        button.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xFF47B96C));
+        button.setColour(juce::TextButton::textColourOffId,  juce::Colour(0xFF3A3A3C));
+        button.setColour(juce::TextButton::textColourOnId,   juce::Colours::white);
+        button.onClick = [this, end]
+        {
+            audioProcessor.setMorphEnd(end);
+            updateMorphButtons();
+        };
+        addAndMakeVisible(button);
+    }
+
+    morphSlider.setLookAndFeel(&unisonLookAndFeel);
+    morphSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    morphSlider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    morphSlider.setPopupDisplayEnabled(true, true, this);
+    morphSlider.setTooltip("Morph");
+    addAndMakeVisible(morphSlider);
+
+    morphStopButton.setButtonText("Off");
+    morphStopButton.setTooltip("Keep the current morph position and release the morph");
+    morphStopButton.setLookAndFeel(&unisonLookAndFeel);
+    morphStopButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xFFB8B9BB));
+    morphStopButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xFF3A3A3C));
+    morphStopButton.onClick = [this]
+    {
+        audioProcessor.stopMorph();
+        updateMorphButtons();
+    };
+    addAndMakeVisible(morphStopButton);
+    updateMorphButtons();
+
+    // Parameter changes only flag a bit; timerCallback repaints once per frame
+    for (int i = 0; i < ParamIds::numParams; ++i)
+    {
+        auto listener = std::make_unique<ChangeBusListener>(audioProcessor, parameterChanges, (ParamIds::Index) i);
+        audioProcessor.getAPVTS().addParameterListener(ParamIds::ids[(size_t) i], listener.get());
+        ownedListeners.push_back(std::move(listener));
+    }
+
+    auditionRenderer->addChangeListener(this);
 
     cachedPresetName = getCurrentPresetName();
+    lastStateGeneration = audioProcessor.getStateGeneration();
     setSize(1320, 760);
     startTimerHz(60);
 }
@@ -367,23 +403,25 @@ ThreeVoicesAudioProcessorEditor::ThreeVoicesAudioProcessorEditor(ThreeVoicesAudi
 ThreeVoicesAudioProcessorEditor::~ThreeVoicesAudioProcessorEditor()
 {
     stopTimer();
+    auditionRenderer->removeChangeListener(this);
+    audioProcessor.getAuditionPlayer().stop();
 
-    for (const auto* id : kVoiceIds)      audioProcessor.getAPVTS().removeParameterListener(id, this);
-    for (const auto* id : kBitIds)        audioProcessor.getAPVTS().removeParameterListener(id, this);
-    for (const auto* id : kTubeIds)       audioProcessor.getAPVTS().removeParameterListener(id, this);
-    audioProcessor.getAPVTS().removeParameterListener("presetChoice", this);
-    audioProcessor.getAPVTS().removeParameterListener("inputGain",    this);
-    audioProcessor.getAPVTS().removeParameterListener("outputGain",   this);
-    audioProcessor.getAPVTS().removeParameterListener("width",        this);
-    audioProcessor.getAPVTS().removeParameterListener("mix",          this);
-    for (const auto* id : kSpeedIds)      audioProcessor.getAPVTS().removeParameterListener(id, this);
-    for (const auto* id : kDelayIds)      audioProcessor.getAPVTS().removeParameterListener(id, this);
-    for (const auto* id : kDepthIds)      audioProcessor.getAPVTS().removeParameterListener(id, this);
-    for (const auto* id : kDistortionIds) audioProcessor.getAPVTS().removeParameterListener(id, this);
+    for (int i = 0; i < (int) ownedListeners.size(); ++i)
+        audioProcessor.getAPVTS().removeParameterListener(ParamIds::ids[(size_t) i], ownedListeners[(size_t) i].get());
 
     presetButton.setLookAndFeel(nullptr);
     previousPresetButton.setLookAndFeel(nullptr);
     nextPresetButton.setLookAndFeel(nullptr);
+    for (auto& button : snapshotSlotButtons)
+        button.setLookAndFeel(nullptr);
+    savePresetButton.setLookAndFeel(nullptr);
+    cabinetTypeBox.setLookAndFeel(nullptr);
+    cabinetMixSlider.setLookAndFeel(nullptr);
+    cabinetLoadButton.setLookAndFeel(nullptr);
+    for (auto& button : morphEndButtons)
+        button.setLookAndFeel(nullptr);
+    morphSlider.setLookAndFeel(nullptr);
+    morphStopButton.setLookAndFeel(nullptr);
     widthSlider.setLookAndFeel(nullptr);
     mixKnob.setLookAndFeel(nullptr);
     inputGainSlider.setLookAndFeel(nullptr);
@@ -410,7 +448,7 @@ void ThreeVoicesAudioProcessorEditor::initialiseControls()
         s.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
         s.setLookAndFeel(&invisibleLookAndFeel);
         s.setInterceptsMouseClicks(true, false);
-        s.onValueChange = [this] { repaint(); };
+        s.onValueChange = [this, &s] { repaint(getSliderRepaintArea(s)); };
         addAndMakeVisible(s);
     };
     auto setupVertical = [this](juce::Slider& s)
@@ -451,7 +489,7 @@ void ThreeVoicesAudioProcessorEditor::initialiseControls()
     mixKnob.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     mixKnob.setLookAndFeel(&invisibleLookAndFeel);
     mixKnob.setInterceptsMouseClicks(true, false);
-    mixKnob.onValueChange = [this] { repaint(); };
+    mixKnob.onValueChange = [this] { repaint(getSliderRepaintArea(mixKnob)); };
     addAndMakeVisible(mixKnob);
 
     inputGainSlider.setSliderStyle(juce::Slider::LinearVertical);
@@ -486,81 +524,20 @@ void ThreeVoicesAudioProcessorEditor::initialiseAttachments()
     mixAttachment        = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "mix",        mixKnob);
     inputGainAttachment  = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "inputGain",  inputGainSlider);
     outputGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "outputGain", outputGainSlider);
+
+    // The items have to exist before the attachment selects one
+    cabinetTypeBox.addItemList(CabinetImpulseLibrary::getTypeNames(), 1);
+    cabinetTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "cabType", cabinetTypeBox);
+    cabinetMixAttachment  = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "cabMix", cabinetMixSlider);
+    morphAttachment       = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "morph", morphSlider);
 }
 
 void ThreeVoicesAudioProcessorEditor::initialiseSideFaderArt() {}
 
-void ThreeVoicesAudioProcessorEditor::buildPresetPreviewLibrary()
-{
-    presetPreviewImages.clear();
-
-    const auto& choices = audioProcessor.getFlattenedPresetChoices();
-    for (int i = 0; i < choices.size(); ++i)
-        presetPreviewImages.add({});
-
-    const auto presetRoot = findPresetImageRoot();
-    if (!presetRoot.isDirectory())
-        return;
-
-    juce::HashMap<juce::String, juce::File> imageFilesByKey;
-    const auto categoryDirs = presetRoot.findChildFiles(juce::File::findDirectories, false);
-
-    for (const auto& categoryDir : categoryDirs)
-    {
-        const auto category = normaliseCategoryFolderName(categoryDir.getFileName());
-        const auto files = categoryDir.findChildFiles(juce::File::findFiles, false, "*");
-
-        for (const auto& file : files)
-        {
-            const auto extension = file.getFileExtension().toLowerCase();
-            if (extension != ".png" && extension != ".jpg" && extension != ".jpeg")
-                continue;
-
-            const auto presetName = stripPresetOrderingPrefix(file.getFileNameWithoutExtension());
-            imageFilesByKey.set(makePresetKey(category, presetName), file);
-        }
-    }
-
-    for (int i = 0; i < choices.size(); ++i)
-    {
-        const auto choice = choices[i];
-        const auto separator = choice.indexOf(" - ");
-        if (separator < 0)
-            continue;
-
-        const auto category = choice.substring(0, separator).trim();
-        const auto preset = choice.substring(separator + 3).trim();
-        const auto key = makePresetKey(category, preset);
-
-        if (imageFilesByKey.contains(key))
-        {
-            auto image = juce::ImageCache::getFromFile(imageFilesByKey[key]);
-            if (image.isValid())
-                presetPreviewImages.set(i, image);
-        }
-    }
-}
-
 // ============================================================================
 juce::File ThreeVoicesAudioProcessorEditor::findAssetFile(const juce::String& fileName) const
 {
-    juce::Array<juce::File> roots;
-    roots.add(juce::File::getCurrentWorkingDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory());
-    for (const auto& root : roots)
-    {
-        auto dir = root;
-        for (int d = 0; d < 6; ++d)
-        {
-            if (dir.getChildFile(fileName).exists())                        return dir.getChildFile(fileName);
-            if (dir.getChildFile("assets").getChildFile(fileName).exists()) return dir.getChildFile("assets").getChildFile(fileName);
-            if (dir.getChildFile("Assets").getChildFile(fileName).exists()) return dir.getChildFile("Assets").getChildFile(fileName);
-            if (dir.isRoot()) break;
-            dir = dir.getParentDirectory();
-        }
-    }
-    return {};
+    return resources->findAsset(fileName);
 }
 
 void ThreeVoicesAudioProcessorEditor::initialiseScreenAnimation()
@@ -612,16 +589,8 @@ juce::Image ThreeVoicesAudioProcessorEditor::loadImageByName(const juce::String&
     if (auto img = fromBinary(); img.isValid()) { DBG("Loaded " + fileName + " from binary"); return img; }
     DBG("Binary not valid for " + fileName + ", searching files");
 
-    juce::Array<juce::File> roots;
-    roots.add(juce::File::getCurrentWorkingDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory());
-    for (const auto& root : roots)
-    {
-        if (root.getChildFile(fileName).existsAsFile())                        return juce::ImageFileFormat::loadFrom(root.getChildFile(fileName));
-        if (root.getChildFile("assets").getChildFile(fileName).existsAsFile()) return juce::ImageFileFormat::loadFrom(root.getChildFile("assets").getChildFile(fileName));
-        if (root.getChildFile("Assets").getChildFile(fileName).existsAsFile()) return juce::ImageFileFormat::loadFrom(root.getChildFile("Assets").getChildFile(fileName));
-    }
+    if (const auto file = findAssetFile(fileName); file.existsAsFile())
+        return juce::ImageFileFormat::loadFrom(file);
     return {};
 }
 
@@ -646,24 +615,20 @@ bool ThreeVoicesAudioProcessorEditor::anyToggleActive() const
 
 juce::String ThreeVoicesAudioProcessorEditor::getCurrentPresetName() const
 {
-    const auto& choices = audioProcessor.getFlattenedPresetChoices();
-    const int idx = juce::jlimit(0, juce::jmax(0, choices.size() - 1), audioProcessor.getCurrentPresetIndex());
-    return choices.isEmpty() ? "PRESET SELECT" : choices[idx];
+    if (libraryPresetName.isNotEmpty() && libraryPresetChoice == audioProcessor.getCurrentPresetIndex())
+        return libraryPresetName;
+
+    const auto& catalog = audioProcessor.getPresetCatalog();
+    return catalog.isEmpty() ? "PRESET SELECT" : catalog.getPreset(audioProcessor.getCurrentPresetIndex()).displayName;
 }
 
 // ============================================================================
 void ThreeVoicesAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    if (bgStandard.isValid())
-    {
-        g.drawImage(bgStandard,
-                    0, 0, getWidth(), getHeight(),
-                    0, 0, bgStandard.getWidth(), bgStandard.getHeight(),
-                    false);
-    }
-    else { g.fillAll(juce::Colour(0xFFBFC0C2)); }
+    // Background, chassis cleanups and track bodies only depend on the layout
+    const auto physicalScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getChassisLayer(physicalScale), getLocalBounds().toFloat());
 
-    drawSliderTrackBodies(g);
     drawSideFaderHandles(g);        // ← was missing
     drawDistortionSliderHandles(g); // ← was missing
     drawWidthSliderOverlay(g);      // ← was missing
@@ -673,6 +638,32 @@ void ThreeVoicesAudioProcessorEditor::paint(juce::Graphics& g)
     drawPresetDisplay(g);
 }
 
+const juce::Image& ThreeVoicesAudioProcessorEditor::getChassisLayer(float physicalScale)
+{
+    // Composited once per size and display scale; every paint after that draws
+    // it pixel for pixel and only the moving parts are drawn on top
+    const int width = juce::jmax(1, juce::roundToInt(getWidth() * physicalScale));
+    const int height = juce::jmax(1, juce::roundToInt(getHeight() * physicalScale));
+
+    if (!chassisLayer.isValid() || chassisLayer.getWidth() != width || chassisLayer.getHeight() != height)
+    {
+        chassisLayer = juce::Image(juce::Image::RGB, width, height, false);
+        juce::Graphics layer(chassisLayer);
+
+        if (bgStandard.isValid())
+        {
+            layer.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+            layer.drawImage(bgStandard, 0, 0, width, height, 0, 0, bgStandard.getWidth(), bgStandard.getHeight(), false);
+        }
+        else { layer.fillAll(juce::Colour(0xFFBFC0C2)); }
+
+        layer.addTransform(juce::AffineTransform::scale(width / (float) getWidth(), height / (float) getHeight()));
+        drawSliderTrackBodies(layer);
+    }
+
+    return chassisLayer;
+}
+
 void ThreeVoicesAudioProcessorEditor::paintOverChildren(juce::Graphics& g)
 {
     juce::ignoreUnused(g);
@@ -728,7 +719,33 @@ void ThreeVoicesAudioProcessorEditor::drawScreenFallbackAnimation(juce::Graphics
 
 void ThreeVoicesAudioProcessorEditor::drawPresetDisplay(juce::Graphics& g)
 {
-    juce::ignoreUnused(g);
+    // The preset's preview stands in for the screen animation when there is none;
+    // it is requested at the physical size it is drawn, so it is decoded once
+    if (!animationFrames.isEmpty())
+        return;
+
+    const auto body = scaleRect(kVideoRef);
+    const auto pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto thumbnail = presetThumbnails.getThumbnail(audioProcessor.getCurrentPresetIndex(),
+                                                         (body.toFloat() * pixelScale).getSmallestIntegerContainer());
+    if (!thumbnail.isValid())
+        return;
+
+    const float us = juce::jmin(getWidth() / (float) designW, getHeight() / (float) designH);
+    juce::Path clip;
+    clip.addRoundedRectangle(body.toFloat(), 8.0f * us);
+
+    g.saveState();
+    g.reduceClipRegion(clip);
+    g.drawImageWithin(thumbnail, body.getX(), body.getY(), body.getWidth(), body.getHeight(),
+                      juce::RectanglePlacement::centred, false);
+    g.restoreState();
+}
+
+void ThreeVoicesAudioProcessorEditor::presetThumbnailReady(int presetIndex)
+{
+    if (presetIndex == audioProcessor.getCurrentPresetIndex())
+        repaint(scaleRect(kVideoRef));
 }
 
 // ============================================================================
@@ -1818,7 +1835,7 @@ void ThreeVoicesAudioProcessorEditor::mouseDrag(const juce::MouseEvent& e)
     if (activeDragSlider)
     {
         activeDragSlider->mouseDrag(e.getEventRelativeTo(activeDragSlider));
-        repaint();
+        repaint(getSliderRepaintArea(*activeDragSlider));
     }
 }
 
@@ -1827,8 +1844,8 @@ void ThreeVoicesAudioProcessorEditor::mouseUp(const juce::MouseEvent& e)
     if (activeDragSlider)
     {
         activeDragSlider->mouseUp(e.getEventRelativeTo(activeDragSlider));
+        repaint(getSliderRepaintArea(*activeDragSlider));
         activeDragSlider = nullptr;
-        repaint();
     }
 }
 
@@ -1839,9 +1856,82 @@ void ThreeVoicesAudioProcessorEditor::mouseWheelMove(const juce::MouseEvent& e,
         s->mouseWheelMove(e.getEventRelativeTo(s), w);
 }
 
+// ============================================================================
+bool ThreeVoicesAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+    const auto mods = key.getModifiers();
+    if (!mods.isCommandDown())
+        return false;
+
+    if (key.getKeyCode() == 'Z')
+        return mods.isShiftDown() ? audioProcessor.redo() : audioProcessor.undo();
+    if (key.getKeyCode() == 'Y')
+        return audioProcessor.redo();
+
+    return false;
+}
+
+// ============================================================================
+bool ThreeVoicesAudioProcessorEditor::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    for (const auto& path : files)
+        if (juce::File(path).isDirectory())
+            return true;
+    return false;
+}
+
+void ThreeVoicesAudioProcessorEditor::filesDropped(const juce::StringArray& files, int, int)
+{
+    for (const auto& path : files)
+        if (const juce::File folder(path); folder.isDirectory())
+            importPresetPack(folder);
+}
+
+void ThreeVoicesAudioProcessorEditor::importPresetPack(const juce::File& packDirectory)
+{
+    const auto bundle = audioProcessor.getPresetPackBundle(packDirectory);
+    audioProcessor.getUserPresets().closePack(bundle);
+
+    // importPack blocks until the whole pack is parsed, so it never runs here
+    auto& processor = audioProcessor;
+    packImportPool.addJob([&processor, packDirectory, bundle, safeThis = juce::Component::SafePointer<ThreeVoicesAudioProcessorEditor>(this)]
+    {
+        auto result = processor.importPresetPack(packDirectory);
+        juce::MessageManager::callAsync([safeThis, bundle, result = std::move(result)]
+        {
+            if (safeThis != nullptr)
+                safeThis->presetPackImported(bundle, result);
+        });
+        return juce::ThreadPoolJob::jobHasFinished;
+    });
+}
+
+void ThreeVoicesAudioProcessorEditor::presetPackImported(const juce::File& bundle, const PresetPackImporter::Result& result)
+{
+    if (result.bundleWritten)
+        audioProcessor.getUserPresets().addPack(bundle);
+
+    // The pack shows up in the preset menu; the report says what did not make it
+    auto report = result.bundleWritten ? juce::String(result.numImported) + " presets imported, "
+                                             + juce::String(result.numSkipped) + " skipped."
+                                       : juce::String("The pack could not be imported.");
+
+    constexpr int maxReportedMessages = 12;
+    for (int i = 0; i < juce::jmin(result.messages.size(), maxReportedMessages); ++i)
+        report << "\n" << result.messages[i];
+    if (result.messages.size() > maxReportedMessages)
+        report << "\n(" << (result.messages.size() - maxReportedMessages) << " more)";
+
+    const auto icon = result.bundleWritten && result.messages.isEmpty() ? juce::MessageBoxIconType::InfoIcon
+                                                                         : juce::MessageBoxIconType::WarningIcon;
+    juce::AlertWindow::showMessageBoxAsync(icon, "Preset Pack: " + bundle.getFileNameWithoutExtension(), report);
+}
+
 // ============================================================================
 void ThreeVoicesAudioProcessorEditor::resized()
 {
+    chassisLayer = {};
+
     // ── Knob row Y positions (design space) ──────────────────────────────────
     // bg_standard.png ring centres: row0≈y483, row1≈y968, row2≈y1454
     // component top = centre - halfSize(152) 
@@ -1880,6 +1970,25 @@ void ThreeVoicesAudioProcessorEditor::resized()
     previousPresetButton.setBounds(scaleRect(kPresetPrevRef));
     nextPresetButton.setBounds (scaleRect(kPresetNextRef));
 
+    auto slotArea = scaleRect(kSnapshotSlotsRef);
+    const int slotWidth = slotArea.getWidth() / ((int) snapshotSlotButtons.size() + 1);
+    savePresetButton.setBounds(slotArea.removeFromRight(slotWidth).reduced(juce::jmax(1, slotWidth / 12), 0));
+    for (auto& button : snapshotSlotButtons)
+        button.setBounds(slotArea.removeFromLeft(slotWidth).reduced(juce::jmax(1, slotWidth / 12), 0));
+
+    auto cabinetArea = scaleRect(kCabinetRef);
+    const int cabinetGap = juce::jmax(1, cabinetArea.getWidth() / 40);
+    cabinetTypeBox.setBounds(cabinetArea.removeFromLeft(cabinetArea.getWidth() * 2 / 5).reduced(0, cabinetGap));
+    cabinetLoadButton.setBounds(cabinetArea.removeFromRight(cabinetArea.getWidth() / 3).reduced(cabinetGap, cabinetGap));
+    cabinetMixSlider.setBounds(cabinetArea.reduced(cabinetGap, 0));
+
+    auto morphArea = scaleRect(kMorphRef);
+    const int morphButtonWidth = morphArea.getWidth() / 6;
+    morphEndButtons[0].setBounds(morphArea.removeFromLeft(morphButtonWidth).reduced(0, cabinetGap));
+    morphStopButton.setBounds(morphArea.removeFromRight(morphButtonWidth).reduced(0, cabinetGap));
+    morphEndButtons[1].setBounds(morphArea.removeFromRight(morphButtonWidth).reduced(cabinetGap, cabinetGap));
+    morphSlider.setBounds(morphArea.reduced(cabinetGap, 0));
+
     if (screenVideo != nullptr)
     {
         screenVideo->setBounds(scaleRect(kVideoRef));
@@ -1900,80 +2009,199 @@ void ThreeVoicesAudioProcessorEditor::openPresetOverlay()
         presetOverlay->setCallbacks(
             [this](int cat, int pre) { onOverlayPresetSelected(cat, pre); },
             [this]()                 { closePresetOverlay(); });
+        presetOverlay->setLibraryCallback([this](int library, int pre) { onOverlayLibraryPresetSelected(library, pre); });
+        presetOverlay->setAuditionCallback([this](int presetIndex) { auditionPreset(presetIndex); });
         addAndMakeVisible(*presetOverlay);
         presetOverlay->setBounds(getLocalBounds());
     }
-    presetOverlay->setPresetLibrary(audioProcessor.getFlattenedPresetChoices());
+    presetOverlay->setPresetLibrary(audioProcessor.getPresetCatalog());
+    presetOverlay->setUserPresets(audioProcessor.getUserPresets());
     presetOverlay->openCategories();
+    auditionRenderer->renderMissing(audioProcessor.getPresetCatalog());
 }
 
 void ThreeVoicesAudioProcessorEditor::closePresetOverlay()
 {
+    auditionPreset(-1);
+    // Hiding the overlay repaints the area it covered
     if (presetOverlay != nullptr) presetOverlay->setVisible(false);
-    repaint();
+}
+
+void ThreeVoicesAudioProcessorEditor::auditionPreset(int presetIndex)
+{
+    auditionedPreset = presetIndex;
+    auditionClipPending = false;
+
+    if (presetIndex < 0)
+        audioProcessor.getAuditionPlayer().stop();
+    else if (auto clip = auditionRenderer->loadClip(presetIndex, audioProcessor.getSampleRate()))
+        audioProcessor.getAuditionPlayer().play(std::move(clip));
+    else
+    {
+        // Not rendered yet: render it next and start it from changeListenerCallback
+        audioProcessor.getAuditionPlayer().stop();
+        auditionRenderer->prioritise(presetIndex);
+        auditionClipPending = true;
+    }
+
+    if (presetOverlay != nullptr)
+        presetOverlay->setAuditioningPreset(presetIndex);
+}
+
+void ThreeVoicesAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    if (auditionClipPending && auditionRenderer->isClipReady(auditionedPreset))
+        auditionPreset(auditionedPreset);
 }
 
 void ThreeVoicesAudioProcessorEditor::stepPreset(int delta)
 {
-    const auto& choices = audioProcessor.getFlattenedPresetChoices();
-    if (choices.isEmpty())
+    const auto& catalog = audioProcessor.getPresetCatalog();
+    if (catalog.isEmpty())
         return;
 
     const int current = audioProcessor.getCurrentPresetIndex();
-    const int next = juce::jlimit(0, choices.size() - 1, current + delta);
+    const int next = juce::jlimit(0, catalog.getNumPresets() - 1, current + delta);
     if (next == current)
         return;
 
     audioProcessor.setCurrentPresetIndex(next);
     audioProcessor.applyImageDerivedPreset(next);
+    libraryPresetName.clear();
     cachedPresetName = getCurrentPresetName();
-    repaint(scaleRect(kPresetOpenRef));
-    repaint(scaleRect(kScreenBodyRef));
+    repaint(getParameterRepaintArea(ParamIds::presetChoice));
 }
 
-void ThreeVoicesAudioProcessorEditor::onOverlayPresetSelected(int cat, int pre)
+void ThreeVoicesAudioProcessorEditor::updateSnapshotSlotButtons()
 {
-    const auto& choices = audioProcessor.getFlattenedPresetChoices();
-    if (choices.isEmpty())
-        return;
+    const int active = audioProcessor.getActiveSnapshotSlot();
+    for (int i = 0; i < (int) snapshotSlotButtons.size(); ++i)
+        snapshotSlotButtons[(size_t) i].setToggleState(i == active, juce::dontSendNotification);
+}
 
-    juce::String currentCategory;
-    int currentCategoryIndex = -1;
-    int absoluteIndex = -1;
-    int categoryCounter = -1;
+void ThreeVoicesAudioProcessorEditor::chooseCabinetImpulse()
+{
+    cabinetChooser = std::make_unique<juce::FileChooser>("Load a cabinet impulse response",
+                                                         audioProcessor.getCabinetImpulseFile(),
+                                                         "*.wav;*.aif;*.aiff;*.flac");
 
-    for (int i = 0; i < choices.size(); ++i)
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    cabinetChooser->launchAsync(flags, [safeThis = juce::Component::SafePointer<ThreeVoicesAudioProcessorEditor>(this)](const juce::FileChooser& chooser)
     {
-        const auto separator = choices[i].indexOf(" - ");
-        if (separator < 0)
-            continue;
+        const auto file = chooser.getResult();
+        if (safeThis == nullptr || file == juce::File())
+            return;
 
-        const auto category = choices[i].substring(0, separator).trim();
-        if (category != currentCategory)
+        if (!safeThis->audioProcessor.loadCabinetImpulse(file))
         {
-            currentCategory = category;
-            ++categoryCounter;
-            currentCategoryIndex = 0;
-        }
-        else
-        {
-            ++currentCategoryIndex;
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Cabinet IR",
+                                                   "Could not read " + file.getFileName() + " as audio.");
+            return;
         }
 
-        if (categoryCounter == cat && currentCategoryIndex == pre)
+        // Loading an IR is a request to hear it
+        if (auto* type = safeThis->audioProcessor.getAPVTS().getParameter("cabType"))
         {
-            absoluteIndex = i;
-            break;
+            type->beginChangeGesture();
+            type->setValueNotifyingHost(type->convertTo0to1((float) CabinetImpulseLibrary::user));
+            type->endChangeGesture();
         }
-    }
 
+        safeThis->updateCabinetLoadButton();
+    });
+}
+
+void ThreeVoicesAudioProcessorEditor::updateMorphButtons()
+{
+    for (int end = 0; end < 2; ++end)
+        morphEndButtons[end].setToggleState(audioProcessor.hasMorphEnd(end), juce::dontSendNotification);
+    morphStopButton.setEnabled(audioProcessor.hasMorphEnd(0) || audioProcessor.hasMorphEnd(1));
+}
+
+void ThreeVoicesAudioProcessorEditor::updateCabinetLoadButton()
+{
+    const auto file = audioProcessor.getCabinetImpulseFile();
+    cabinetLoadButton.setTooltip(file == juce::File() ? juce::String("Load a user IR")
+                                                      : "User IR: " + file.getFileName());
+}
+
+void ThreeVoicesAudioProcessorEditor::onOverlayPresetSelected(int cat, int pre)
+{
+    const int absoluteIndex = audioProcessor.getPresetCatalog().getPresetIndex(cat, pre);
     if (absoluteIndex < 0)
         return;
 
+    auditionPreset(-1);
+
     audioProcessor.setCurrentPresetIndex(absoluteIndex);
     audioProcessor.applyImageDerivedPreset(absoluteIndex);
+    libraryPresetName.clear();
+    cachedPresetName = getCurrentPresetName();
+    // The controls the preset moves are repainted through parameterChanges
+    repaint(getParameterRepaintArea(ParamIds::presetChoice));
+}
+
+void ThreeVoicesAudioProcessorEditor::onOverlayLibraryPresetSelected(int library, int presetIndex)
+{
+    auditionPreset(-1);
+
+    const auto& store = audioProcessor.getUserPresets();
+    const int pack = library - PresetMenuOverlay::firstPackLibrary;
+    const bool applied = library == PresetMenuOverlay::userLibrary ? audioProcessor.applyUserPreset(presetIndex)
+                                                                   : audioProcessor.applyPackPreset(pack, presetIndex);
+    if (!applied)
+        return;
+
+    libraryPresetName = library == PresetMenuOverlay::userLibrary ? store.getName(presetIndex)
+                                                                  : store.getPack(pack).getName(presetIndex);
+    libraryPresetChoice = audioProcessor.getCurrentPresetIndex();
+    cachedPresetName = getCurrentPresetName();
+    repaint(getParameterRepaintArea(ParamIds::presetChoice));
+}
+
+void ThreeVoicesAudioProcessorEditor::showSavePresetWindow()
+{
+    savePresetWindow = std::make_unique<juce::AlertWindow>("Save Preset", "Save the current sound to your user presets.",
+                                                           juce::MessageBoxIconType::NoIcon, this);
+    savePresetWindow->addTextEditor("name", libraryPresetName.isNotEmpty() ? libraryPresetName : juce::String(), "Name");
+    savePresetWindow->addTextEditor("category", "User", "Category");
+    savePresetWindow->addTextEditor("tags", {}, "Tags");
+    savePresetWindow->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    savePresetWindow->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    savePresetWindow->enterModalState(true, juce::ModalCallbackFunction::create(
+        [safeThis = juce::Component::SafePointer<ThreeVoicesAudioProcessorEditor>(this)](int result)
+        {
+            if (safeThis != nullptr)
+                safeThis->savePresetWindowClosed(result);
+        }));
+}
+
+void ThreeVoicesAudioProcessorEditor::savePresetWindowClosed(int result)
+{
+    if (savePresetWindow == nullptr)
+        return;
+
+    const auto name = savePresetWindow->getTextEditorContents("name").trim();
+    const auto category = savePresetWindow->getTextEditorContents("category").trim();
+    const auto tags = savePresetWindow->getTextEditorContents("tags").trim();
+    savePresetWindow.reset();
+
+    if (result == 0 || name.isEmpty())
+        return;
+
+    if (audioProcessor.saveUserPreset(name, category, tags) == juce::File())
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Save Preset",
+                                               "Could not write the preset to " + audioProcessor.getUserPresets().getDirectory().getFullPathName() + ".");
+        return;
+    }
+
+    // The store indexes the file in the background; the name is shown now
+    libraryPresetName = name;
+    libraryPresetChoice = audioProcessor.getCurrentPresetIndex();
     cachedPresetName = getCurrentPresetName();
-    repaint();
+    repaint(getParameterRepaintArea(ParamIds::presetChoice));
 }
 
 void ThreeVoicesAudioProcessorEditor::timerCallback()
@@ -1982,13 +2210,113 @@ void ThreeVoicesAudioProcessorEditor::timerCallback()
     if (advanceFallbackAnimationFrame())
         repaint(scaleRect(kScreenBodyRef));
     const auto current = getCurrentPresetName();
-    if (current != cachedPresetName) { cachedPresetName = current; repaint(); }
+    if (current != cachedPresetName) { cachedPresetName = current; repaint(getParameterRepaintArea(ParamIds::presetChoice)); }
+
+    // A restored state replaces everything at once: one full repaint
+    if (const auto generation = audioProcessor.getStateGeneration(); generation != lastStateGeneration)
+    {
+        lastStateGeneration = generation;
+        parameterChanges.markAllDirty();
+        libraryPresetName.clear();
+        updateCabinetLoadButton();
+        updateMorphButtons();
+    }
+
+    const auto changed = parameterChanges.consume();
+
+    // Everything dirty: one full repaint, with no per-control areas on top and
+    // nothing carried into the next frame
+    if (ParameterChangeBus::isAll(changed))
+    {
+        previousParameterChanges = 0;
+        repaint();
+        return;
+    }
+
+    // Attachments push values into the controls asynchronously, so a change
+    // seen this frame is repainted again next frame in case it landed late.
+    const auto toRepaint = changed | previousParameterChanges;
+    previousParameterChanges = changed;
+
+    if (toRepaint == 0)
+        return;
+
+    for (int i = 0; i < ParamIds::numParams; ++i)
+    {
+        if (!ParameterChangeBus::contains(toRepaint, (ParamIds::Index) i))
+            continue;
+
+        const auto area = getParameterRepaintArea((ParamIds::Index) i);
+        if (!area.isEmpty())
+            repaint(area);
+    }
 }
 
-void ThreeVoicesAudioProcessorEditor::parameterChanged(const juce::String&, float)
+juce::Rectangle<int> ThreeVoicesAudioProcessorEditor::getSliderRepaintArea(const juce::Slider& slider) const
 {
-    juce::MessageManager::callAsync(
-        [safe = juce::Component::SafePointer<ThreeVoicesAudioProcessorEditor>(this)]
-        { if (safe != nullptr) safe->repaint(); });
+    const float us = juce::jmin(getWidth() / (float) designW, getHeight() / (float) designH);
+    const int sideThumb  = (int) std::ceil(kSideFaderKnobOuterSize * us);
+    const int smallThumb = (int) std::ceil(kSmallFaderKnobOuterSize * us);
+
+    // Faders: the thumb's whole travel, since the old position needs clearing too
+    if (&slider == &inputGainSlider)
+        return inputGainSlider.getBounds().getUnion(scaleRect(kLeftFaderCutoutRef).expanded(sideThumb));
+    if (&slider == &outputGainSlider)
+        return outputGainSlider.getBounds().getUnion(scaleRect(kRightFaderCutoutRef).expanded(sideThumb));
+    if (&slider == &widthSlider)
+        return widthSlider.getBounds().getUnion(scaleRect(kWidthCutoutRef).expanded(smallThumb));
+
+    for (int v = 0; v < 3; ++v)
+        if (&slider == &rows[(size_t) v].distortionSlider)
+            return slider.getBounds().getUnion(scaleRect(kDistortionCutoutRefs[(size_t) v]).expanded(smallThumb));
+
+    // Knobs: only the cap and its shadow move (see drawSingleRotaryKnobOverlay)
+    const auto area = slider.getBounds().toFloat();
+    const float capR = juce::jmin(area.getWidth(), area.getHeight()) * 0.5f * 0.47f;
+    return juce::Rectangle<float>(capR * 2.0f, capR * 2.0f).withCentre(area.getCentre())
+               .expanded(capR * 0.2f).getSmallestIntegerContainer();
+}
+
+juce::Rectangle<int> ThreeVoicesAudioProcessorEditor::getParameterRepaintArea(ParamIds::Index index) const
+{
+    switch (index)
+    {
+        case ParamIds::inputGain:
+            return getSliderRepaintArea(inputGainSlider);
+        case ParamIds::outputGain:
+            return getSliderRepaintArea(outputGainSlider);
+        case ParamIds::width:
+            return getSliderRepaintArea(widthSlider);
+        case ParamIds::mix:
+            return getSliderRepaintArea(mixKnob);
+        case ParamIds::presetChoice:
+            return scaleRect(kPresetOpenRef).getUnion(scaleRect(kScreenBodyRef));
+        default:
+            break;
+    }
+
+    for (int v = 0; v < 3; ++v)
+    {
+        const auto& row = rows[(size_t) v];
+
+        if (index == ParamIds::legacyVoiceOn(v) || index == ParamIds::forVoice(v, ParamIds::voiceOn))
+            return row.voiceButton.getBounds();
+        if (index == ParamIds::legacyVoiceBit(v) || index == ParamIds::forVoice(v, ParamIds::voiceBit))
+            return row.bitButton.getBounds();
+        if (index == ParamIds::legacyVoiceTube(v) || index == ParamIds::forVoice(v, ParamIds::voiceTube))
+            return row.tubeButton.getBounds();
+        if (index == ParamIds::forVoice(v, ParamIds::voiceSpeed))
+            return getSliderRepaintArea(row.speedKnob);
+        if (index == ParamIds::forVoice(v, ParamIds::voiceDelayTime))
+            return getSliderRepaintArea(row.delayKnob);
+        if (index == ParamIds::forVoice(v, ParamIds::voiceDepth))
+            return getSliderRepaintArea(row.depthKnob);
+        if (index == ParamIds::forVoice(v, ParamIds::voiceDistortion))
+            return getSliderRepaintArea(row.distortionSlider);
+    }
+
+    // Not drawn by the editor: legacy globals, and the cabinet controls, which
+    // are ordinary components and repaint themselves
+    return {};
 }
   
@@ -9,9 +9,12 @@
 #include <juce_video/juce_video.h>
 
 #include "PluginProcessor.h"
+#include "presets/AuditionRenderer.h"
+#include "state/ParameterChangeBus.h"
 #include "ui/UnisonLookAndFeel.h"
 #include "ui/InvisibleLookAndFeel.h"
 #include "ui/PresetMenuOverlay.h"
+#include "ui/PresetThumbnailCache.h"
 
 // Slider with paint() suppressed — used as invisible value holder only.
 // Visual rendering is done by the parent editor via paintOverChildren().
@@ -29,8 +32,9 @@ struct SilentSlider : public juce::Slider
 };
 
 class ThreeVoicesAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                        private juce::AudioProcessorValueTreeState::Listener,
-                                        private juce::Timer
+                                        public juce::FileDragAndDropTarget,
+                                        private juce::Timer,
+                                        private juce::ChangeListener
 {
 public:
     explicit ThreeVoicesAudioProcessorEditor(ThreeVoicesAudioProcessor&);
@@ -46,6 +50,13 @@ public:
     void mouseUp    (const juce::MouseEvent&) override;
     void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails&) override;
 
+    // Cmd/Ctrl+Z undo, Cmd/Ctrl+Shift+Z or Cmd/Ctrl+Y redo
+    bool keyPressed(const juce::KeyPress&) override;
+
+    // Dropping a folder of preset XML imports it as a preset pack
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
 private:
     static constexpr int designW = 3366;
     static constexpr int designH = 1945;
@@ -74,7 +85,6 @@ private:
     void initialiseControls();
     void initialiseAttachments();
     void initialiseSideFaderArt();
-    void buildPresetPreviewLibrary();
 
     juce::Rectangle<int> scaleRect(const juce::Rectangle<int>& ref) const;
     void loadImages();
@@ -105,21 +115,33 @@ private:
     void openPresetOverlay();
     void closePresetOverlay();
     void onOverlayPresetSelected(int categoryIndex, int presetIndex);
+    void onOverlayLibraryPresetSelected(int library, int presetIndex);
     void stepPreset(int delta);
+    void updateSnapshotSlotButtons();
 
     void timerCallback() override;
-    void parameterChanged(const juce::String&, float) override;
+
+    // Area to repaint when the given parameter changes; empty if not drawn.
+    juce::Rectangle<int> getParameterRepaintArea(ParamIds::Index index) const;
+    // Area a slider draws into: a fader's thumb travel or a knob's cap.
+    juce::Rectangle<int> getSliderRepaintArea(const juce::Slider& slider) const;
 
     // Returns the linear slider whose bounds contain localPos, or nullptr.
     juce::Slider* findLinearSliderAt(juce::Point<int> localPos);
 
     ThreeVoicesAudioProcessor& audioProcessor;
+    juce::SharedResourcePointer<ResourceLocator> resources;
     UnisonLookAndFeel unisonLookAndFeel;
     InvisibleLookAndFeel invisibleLookAndFeel;
 
     juce::Image bgStandard;
     juce::Image bgButtonsOn;
 
+    // bgStandard plus drawSliderTrackBodies() at the editor's physical pixel
+    // size; rebuilt on resize or when the display scale changes
+    juce::Image chassisLayer;
+    const juce::Image& getChassisLayer(float physicalScale);
+
     juce::Image menuCategories;
     juce::Image menuClassicMod;
     juce::Image menuGuitar;
@@ -146,19 +168,72 @@ private:
     juce::TextButton presetButton;
     juce::TextButton previousPresetButton;
     juce::TextButton nextPresetButton;
+    std::array<juce::TextButton, ThreeVoicesAudioProcessor::numSnapshotSlots> snapshotSlotButtons;
+
+    // After the compare slots: saves the current sound to the user library
+    juce::TextButton savePresetButton;
+    std::unique_ptr<juce::AlertWindow> savePresetWindow;
+    void showSavePresetWindow();
+    void savePresetWindowClosed(int result);
+
+    // Cabinet strip above the compare slots: IR type, cabinet mix and a file
+    // chooser for the user IR (loading one also selects "User IR")
+    juce::ComboBox cabinetTypeBox;
+    juce::Slider cabinetMixSlider;
+    juce::TextButton cabinetLoadButton;
+    std::unique_ptr<juce::FileChooser> cabinetChooser;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> cabinetTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> cabinetMixAttachment;
+    void chooseCabinetImpulse();
+    void updateCabinetLoadButton();
+
+    // Morph strip above the cabinet strip: store what is heard as end A or B,
+    // glide between them with the morph slider, or release the morph
+    juce::TextButton morphEndButtons[2];
+    juce::Slider morphSlider;
+    juce::TextButton morphStopButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> morphAttachment;
+    void updateMorphButtons();
     std::unique_ptr<PresetMenuOverlay> presetOverlay;
+
+    // Preset previews: clips are rendered in the background the first time the
+    // overlay opens; a click on a preset still rendering plays once it is ready.
+    juce::SharedResourcePointer<AuditionRenderer> auditionRenderer;
+    int auditionedPreset = -1;
+    bool auditionClipPending = false;
+    void auditionPreset(int presetIndex);
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    // Preview images, decoded in the background the first time a preset is shown
+    PresetThumbnailCache presetThumbnails { audioProcessor.getPresetCatalog(),
+                                            [this](int presetIndex) { presetThumbnailReady(presetIndex); } };
+    void presetThumbnailReady(int presetIndex);
     std::unique_ptr<juce::VideoComponent> screenVideo;
     juce::Array<juce::Image> animationFrames;
-    juce::Array<juce::Image> presetPreviewImages;
     int currentAnimationFrame = 0;
 
+    // One listener per parameter (ParamIds order), all feeding parameterChanges
     std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::Listener>> ownedListeners;
+    ParameterChangeBus parameterChanges;
+    juce::uint64 previousParameterChanges = 0;
+    juce::uint32 lastStateGeneration = 0;
 
     juce::CriticalSection stateLock;
     juce::String cachedPresetName;
 
+    // A user library preset leaves presetChoice alone, so its name is shown
+    // for as long as presetChoice still has the value it had when loaded
+    juce::String libraryPresetName;
+    int libraryPresetChoice = -1;
+
     // Mouse forwarding state
     juce::Slider* activeDragSlider = nullptr;
 
+    // Preset pack imports run here, one at a time; declared last so the pool
+    // finishes any import before the rest of the editor is destroyed
+    void importPresetPack(const juce::File& packDirectory);
+    void presetPackImported(const juce::File& bundle, const PresetPackImporter::Result& result);
+    juce::ThreadPool packImportPool { 1 };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThreeVoicesAudioProcessorEditor)
 };
@@ -1,194 +1,157 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "state/FactoryPresets.h"
+
+#include <cmath>
+
+#include <juce_audio_formats/juce_audio_formats.h>
 
 namespace
 {
-juce::String sanitisePresetDisplayName(juce::String name)
+// Bit v = on, bit 3 + v = tube, bit 6 + v = bit, legacy duplicates ORed in
+template <typename ValueOf>
+juce::uint32 resolveVoiceFlags(ValueOf&& valueOf)
 {
-    name = name.trim();
-    while (name.contains("  "))
-        name = name.replace("  ", " ");
-    name = name.replace("_", " ");
-    name = name.replace(".png", "", true);
-    name = name.replace(".jpg", "", true);
-    name = name.replace(".jpeg", "", true);
-    return name.trim();
-}
+    auto isSet = [&valueOf](ParamIds::Index index) { return valueOf(index) > 0.5f; };
 
-juce::String stripPresetOrderingPrefix(juce::String name)
-{
-    name = sanitisePresetDisplayName(name);
-
-    int index = 0;
-    while (index < name.length() && juce::CharacterFunctions::isDigit(name[index]))
-        ++index;
-
-    if (index > 0)
+    juce::uint32 flags = 0;
+    for (int v = 0; v < 3; ++v)
     {
-        while (index < name.length() && (name[index] == ' ' || name[index] == '-' || name[index] == '_'))
-            ++index;
-        name = name.substring(index).trim();
+        if (isSet(ParamIds::forVoice(v, ParamIds::voiceOn)) || isSet(ParamIds::legacyVoiceOn(v)))
+            flags |= 1u << v;
+        if (isSet(ParamIds::forVoice(v, ParamIds::voiceTube)) || isSet(ParamIds::legacyVoiceTube(v)))
+            flags |= 1u << (3 + v);
+        if (isSet(ParamIds::forVoice(v, ParamIds::voiceBit)) || isSet(ParamIds::legacyVoiceBit(v)))
+            flags |= 1u << (6 + v);
     }
-
-    return sanitisePresetDisplayName(name);
+    return flags;
 }
 
-juce::String normaliseCategoryFolderName(juce::String folderName)
+// Morph ends travel in the state properties as raw little-endian floats
+juce::String encodeParameterValues(const ParameterValues& values)
 {
-    folderName = sanitisePresetDisplayName(folderName);
-    if (folderName.equalsIgnoreCase("Keys Synth")
-        || folderName.equalsIgnoreCase("Keys / Synth")
-        || folderName.equalsIgnoreCase("Keys _ Synth"))
-        return "Keys / Synth";
-    return folderName;
+    juce::MemoryOutputStream out;
+    for (const auto value : values)
+        out.writeFloat(value);
+    return out.getMemoryBlock().toBase64Encoding();
 }
 
-juce::File findPresetImageRoot()
+// Values past the end of an older encoding keep what values holds on entry
+bool decodeParameterValues(const juce::String& text, ParameterValues& values)
 {
-    juce::Array<juce::File> roots;
-    roots.add(juce::File::getCurrentWorkingDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory());
+    juce::MemoryBlock block;
+    if (text.isEmpty() || !block.fromBase64Encoding(text))
+        return false;
 
-    for (const auto& root : roots)
-    {
-        auto dir = root;
-        for (int d = 0; d < 6; ++d)
-        {
-            const auto candidate = dir.getChildFile("Unison Mod PRESETS");
-            if (candidate.isDirectory())
-                return candidate;
-            if (dir.isRoot())
-                break;
-            dir = dir.getParentDirectory();
-        }
-    }
-    return {};
+    juce::MemoryInputStream in(block, false);
+    const auto count = juce::jmin(values.size(), block.getSize() / sizeof(float));
+    for (size_t i = 0; i < count; ++i)
+        values[i] = in.readFloat();
+    return true;
 }
-
-juce::String makePresetKey(const juce::String& category, const juce::String& preset)
-{
-    auto key = (normaliseCategoryFolderName(category) + "|" + sanitisePresetDisplayName(preset)).toLowerCase();
-    key = key.removeCharacters(" .,_'!-+()/\\");
-    return key;
 }
 
-juce::File findImageDerivedPresetFile()
+ThreeVoicesAudioProcessor::ThreeVoicesAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+    : AudioProcessor(BusesProperties()
+#if !JucePlugin_IsMidiEffect
+#if !JucePlugin_IsSynth
+        .withInput("Input", juce::AudioChannelSet::stereo(), true)
+#endif
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+#endif
+    ),
+#endif
+    presetCatalog(PresetCatalog::build()),
+    apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
-    juce::Array<juce::File> roots;
-    roots.add(juce::File::getCurrentWorkingDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory());
-    roots.add(juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory());
-
-    for (const auto& root : roots)
+    for (int i = 0; i < ParamIds::numParams; ++i)
     {
-        auto dir = root;
-        for (int d = 0; d < 6; ++d)
-        {
-            const auto candidate = dir.getChildFile("Presets").getChildFile("ImageDerived.xml");
-            if (candidate.existsAsFile())
-                return candidate;
-            if (dir.isRoot())
-                break;
-            dir = dir.getParentDirectory();
-        }
+        parameters[(size_t) i] = apvts.getParameter(ParamIds::ids[(size_t) i]);
+        rawParams[(size_t) i] = apvts.getRawParameterValue(ParamIds::ids[(size_t) i]);
+        jassert(parameters[(size_t) i] != nullptr); // ParamIds out of sync with createParameterLayout()
+        jassert(parameters[(size_t) i]->getParameterIndex() == i);
+        parameters[(size_t) i]->addListener(this);
     }
 
-    return {};
-}
-}
+    for (const auto* id : ParamIds::ids)
+        apvts.addParameterListener(id, this);
 
-juce::StringArray ThreeVoicesAudioProcessor::createFlattenedPresetChoices()
-{
-    if (const auto presetRoot = findPresetImageRoot(); presetRoot.isDirectory())
+    // Morph: switches and choices flip halfway; gains and the preset/morph
+    // controls themselves always follow the live parameters
+    juce::uint64 discreteMask = 0, morphableMask = 0;
+    for (int i = 0; i < ParamIds::numParams; ++i)
     {
-        const juce::StringArray categoryOrder {
-            "Classic Modulation", "Guitar", "Keys / Synth", "Bass", "Drums", "Vocals"
-        };
-
-        juce::StringArray out;
-        juce::Array<juce::File> categories;
-        categories = presetRoot.findChildFiles(juce::File::findDirectories, false);
+        const auto bit = juce::uint64 { 1 } << i;
+        if (parameters[(size_t) i]->isDiscrete())
+            discreteMask |= bit;
+        if (i != ParamIds::inputGain && i != ParamIds::outputGain
+            && i != ParamIds::presetChoice && i != ParamIds::morph)
+            morphableMask |= bit;
+    }
+    presetMorph.setParameterKinds(discreteMask, morphableMask);
 
-        auto categorySortKey = [&categoryOrder](const juce::File& file)
-        {
-            const auto category = normaliseCategoryFolderName(file.getFileName());
-            const int index = categoryOrder.indexOf(category);
-            return index >= 0 ? index : 1000;
-        };
-
-        std::sort(categories.begin(), categories.end(),
-                  [&categorySortKey](const juce::File& a, const juce::File& b)
-                  {
-                      const auto keyA = categorySortKey(a);
-                      const auto keyB = categorySortKey(b);
-                      return keyA == keyB ? a.getFileName() < b.getFileName() : keyA < keyB;
-                  });
-
-        for (const auto& categoryDir : categories)
-        {
-            const auto category = normaliseCategoryFolderName(categoryDir.getFileName());
-            auto presetFiles = categoryDir.findChildFiles(juce::File::findFiles, false, "*");
-            presetFiles.sort();
+    resolvedVoiceFlags.store(resolveVoiceFlags([this](ParamIds::Index i) { return getRawValue(i); }));
+}
 
-            for (const auto& presetFile : presetFiles)
-            {
-                const auto extension = presetFile.getFileExtension().toLowerCase();
-                if (extension == ".png" || extension == ".jpg" || extension == ".jpeg")
-                    out.add(category + " - " + stripPresetOrderingPrefix(presetFile.getFileNameWithoutExtension()));
-            }
-        }
+ThreeVoicesAudioProcessor::~ThreeVoicesAudioProcessor()
+{
+    for (const auto* id : ParamIds::ids)
+        apvts.removeParameterListener(id, this);
 
-        if (!out.isEmpty())
-            return out;
-    }
+    for (auto* parameter : parameters)
+        parameter->removeListener(this);
+}
 
-    juce::StringArray out;
+void ThreeVoicesAudioProcessor::parameterValueChanged(int parameterIndex, float newValue)
+{
+    juce::ignoreUnused(parameterIndex, newValue);
+}
 
-    const juce::StringArray categories {
-        "Classic Modulation", "Guitar", "Keys / Synth", "Bass", "Drums", "Vocals"
-    };
+void ThreeVoicesAudioProcessor::parameterGestureChanged(int parameterIndex, bool gestureIsStarting)
+{
+    // Processor parameter indices follow ParamIds (checked in the constructor)
+    if (parameterIndex < 0 || parameterIndex >= ParamIds::numParams)
+        return;
 
-    const std::array<juce::StringArray, 6> presets {{
-        { "Welcome Chorus", "Mono Phase", "Rotary Paradise", "Color Of Love", "Saturated Warble",
-          "Darko", "Time Frames", "Mirage", "All Three Voices", "Claustrophobic" },
-        { "Instant Chorus", "Super Unison", "Guitar Lead I", "Guitar Lead II", "Guitar Lead III",
-          "Purple Mk.Prince", "Acoustic Nylon", "Black Hole Garden", "Tape Warble", "Seasick" },
-        { "That's Better", "Speed + Movement", "Nostalgic Aqua Lead", "Laura Palmer", "Wavy Pluck",
-          "More Space", "Mono Rhodes", "Terminator II", "Distorted Lead", "Demarco Days" },
-        { "Underwater", "Analog Movement", "1960's Slap Delay", "White Stripes Bass Player", "Moog Wide",
-          "Just Like The Cure", "Silverlake", "Plucky Synth Bass", "As You Are", "Slammed" },
-        { "Wide Kit", "Mono Break", "Trash Loop", "Crush Room", "Phase Bus",
-          "Dirty OH", "Vintage Groove", "Cymbal Swirl", "Tape Drift", "Snap Room" },
-        { "Vocal Double", "Unison Belt", "Yachty In Poland", "Classic Slapback", "Hypnosis",
-          "Subtle BG's", "Massive Vox", "Hurdy Gurdy", "Psychedelic Anthem", "Distorted Crimson" }
-    }};
+    const auto value = getRawValue((ParamIds::Index) parameterIndex);
+    if (gestureIsStarting)
+        undoHistory.beginGesture(parameterIndex, value);
+    else
+        undoHistory.endGesture(parameterIndex, value);
+}
 
-    for (int c = 0; c < (int) categories.size(); ++c)
-        for (const auto& p : presets[(size_t) c])
-            out.add(categories[c] + " - " + p);
+bool ThreeVoicesAudioProcessor::undo()
+{
+    auto values = captureParameterValues();
+    if (!undoHistory.undo(values))
+        return false;
 
-    return out;
+    applyParameterValues(values);
+    return true;
 }
 
-ThreeVoicesAudioProcessor::ThreeVoicesAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-    : AudioProcessor(BusesProperties()
-#if !JucePlugin_IsMidiEffect
-#if !JucePlugin_IsSynth
-        .withInput("Input", juce::AudioChannelSet::stereo(), true)
-#endif
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
-#endif
-    ),
-#endif
-    flattenedPresetChoices(createFlattenedPresetChoices()),
-    apvts(*this, nullptr, "Parameters", createParameterLayout())
+bool ThreeVoicesAudioProcessor::redo()
 {
+    auto values = captureParameterValues();
+    if (!undoHistory.redo(values))
+        return false;
+
+    applyParameterValues(values);
+    return true;
 }
 
-ThreeVoicesAudioProcessor::~ThreeVoicesAudioProcessor()
+void ThreeVoicesAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
 {
+    // Called after the raw value is updated, on whichever thread changed it.
+    // Re-resolving the voice switches is a handful of loads, cheaper than
+    // matching the ID.
+    juce::ignoreUnused(parameterID, newValue);
+    if (bulkRestoreInProgress.load())
+        return; // applyParameterValues resolves once, before the snapshot is released
+
+    resolvedVoiceFlags.store(resolveVoiceFlags([this](ParamIds::Index i) { return getRawValue(i); }));
+    stateChangeCounter.fetch_add(1, std::memory_order_release);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout ThreeVoicesAudioProcessor::createParameterLayout()
@@ -250,7 +213,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout ThreeVoicesAudioProcessor::c
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID("presetChoice", 1),
         "Preset Choice",
-        flattenedPresetChoices,
+        presetCatalog.getDisplayNames(),
         0));
 
     // Voice parameters
@@ -291,26 +254,91 @@ juce::AudioProcessorValueTreeState::ParameterLayout ThreeVoicesAudioProcessor::c
             juce::ParameterID(prefix + "Bit", 1), "Voice " + juce::String(i) + " Bit", false));
     }
 
+    // Morph position between the two morph snapshots (A = 0%, B = 100%)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("morph", 1), "Morph",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
+
+    // Cabinet / room convolution on the summed voices
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("cabType", 1), "Cabinet",
+        CabinetImpulseLibrary::getTypeNames(), CabinetImpulseLibrary::off));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("cabMix", 1), "Cabinet Mix",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 100.0f));
+
     return { params.begin(), params.end() };
 }
 
 void ThreeVoicesAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    // Parameters missing from an older binary blob fall back to their defaults
+    auto values = getDefaultParameterValues();
+    juce::StringPairArray properties;
 
-    if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    if (!BinaryState::read(data, (size_t) juce::jmax(0, sizeInBytes), values, &properties))
+    {
+        // Legacy XML state from earlier versions, read the same way: parameters
+        // it lacks fall back to their defaults. Data in neither format is ignored.
+        std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+        if (xmlState.get() == nullptr || !xmlState->hasTagName(apvts.state.getType()))
+            return;
+
+        forEachXmlChildElementWithTagName(*xmlState, paramXml, "PARAM")
+        {
+            const auto index = ParamIds::find(paramXml->getStringAttribute("id").toRawUTF8());
+            if (index >= 0)
+                values[(size_t) index] = (float) paramXml->getDoubleAttribute("value");
+        }
+    }
 
     // Always start the side gain faders at 0 dB after restoring state.
-    auto resetParam = [this](const char* id, float value)
+    values[ParamIds::inputGain]  = 0.0f;
+    values[ParamIds::outputGain] = 0.0f;
+    values[ParamIds::width]      = 50.0f;
+
+    // A user IR that has moved since the session was saved is dropped; the
+    // cabinet then stays silent until the user loads one again
+    const juce::String impulsePath = properties["cabinetImpulse"];
+    const auto impulseFile = juce::File::isAbsolutePath(impulsePath) ? juce::File(impulsePath) : juce::File();
+    if (impulseFile != getCabinetImpulseFile() && !loadCabinetImpulse(impulseFile))
+        loadCabinetImpulse({});
+
+    restoreParameterValues(values);
+
+    // The morph resumes with the ends it was saved with; a state without
+    // both ends plays the restored parameters directly
+    presetMorph.disable();
     {
-        if (auto* p = apvts.getParameter(id))
-            p->setValueNotifyingHost(p->convertTo0to1(value));
-    };
-    resetParam("inputGain",  0.0f);
-    resetParam("outputGain", 0.0f);
-    resetParam("width",      50.0f);
+        const juce::ScopedLock sl(stateCacheLock);
+        morphEndSet.fill(false);
+    }
+    for (int end = 0; end < 2; ++end)
+    {
+        auto endValues = getDefaultParameterValues();
+        if (decodeParameterValues(properties[end == 0 ? "morphA" : "morphB"], endValues))
+            storeMorphEnd(end, endValues);
+    }
+    if (morphEndSet[0] && morphEndSet[1])
+        presetMorph.setTargets(morphEnds[0], morphEnds[1]);
+}
+
+void ThreeVoicesAudioProcessor::restoreParameterValues(const ParameterValues& values)
+{
+    // Listener fan-out is suspended while the values go in; the DSP sees one
+    // snapshot, and the editor gets a single "state replaced" notification.
+    bulkRestoreInProgress.store(true);
+    applyParameterValues(values);
+    bulkRestoreInProgress.store(false);
+
+    // A restored state starts a fresh history and fresh compare slots
+    undoHistory.clear();
+    snapshotSlotFilled.fill(false);
+
+    // applyParameterValues resolved the voice switches before releasing the snapshot
+    stateChangeCounter.fetch_add(1, std::memory_order_release);
+    stateGeneration.fetch_add(1, std::memory_order_release);
 }
 
 const juce::String ThreeVoicesAudioProcessor::getName() const
@@ -347,7 +375,8 @@ bool ThreeVoicesAudioProcessor::isMidiEffect() const
 
 double ThreeVoicesAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.2; // 200ms to account for max delay + modulation
+    // 200ms to account for max delay + modulation, plus the longest cabinet IR
+    return 0.2 + CabinetImpulseLibrary::maxImpulseSeconds;
 }
 
 int ThreeVoicesAudioProcessor::getNumPrograms()
@@ -378,71 +407,342 @@ void ThreeVoicesAudioProcessor::changeProgramName(int index, const juce::String&
 
 int ThreeVoicesAudioProcessor::getCurrentPresetIndex() const
 {
-    if (auto* p = apvts.getRawParameterValue("presetChoice"))
-        return (int) p->load();
-    return 0;
+    return (int) getRawValue(ParamIds::presetChoice);
 }
 
 void ThreeVoicesAudioProcessor::setCurrentPresetIndex(int index)
 {
     if (auto* p = apvts.getParameter("presetChoice"))
-        p->setValueNotifyingHost(p->convertTo0to1((float) juce::jlimit(0, flattenedPresetChoices.size() - 1, index)));
+        p->setValueNotifyingHost(p->convertTo0to1((float) juce::jlimit(0, presetCatalog.getNumPresets() - 1, index)));
 }
 
 bool ThreeVoicesAudioProcessor::applyImageDerivedPreset(int index)
 {
-    if (index < 0 || index >= flattenedPresetChoices.size())
+    // Build the whole preset first, then apply it as one transaction
+    auto values = captureParameterValues();
+    if (!resolveImageDerivedPreset(index, values))
         return false;
 
-    return applyImageDerivedPreset(flattenedPresetChoices[index]);
+    const auto before = captureParameterValues();
+    applyParameterValues(values);
+    undoHistory.recordTransaction(before, captureParameterValues());
+    return true;
 }
 
-bool ThreeVoicesAudioProcessor::applyImageDerivedPreset(const juce::String& flattenedChoice)
+bool ThreeVoicesAudioProcessor::resolveImageDerivedPreset(int index, ParameterValues& values) const
 {
-    const auto separator = flattenedChoice.indexOf(" - ");
-    if (separator < 0)
+    if (index < 0 || index >= presetCatalog.getNumPresets())
         return false;
 
-    const auto category = flattenedChoice.substring(0, separator).trim();
-    const auto preset = flattenedChoice.substring(separator + 3).trim();
-    const auto key = makePresetKey(category, preset);
-    const auto presetFile = findImageDerivedPresetFile();
+    const auto& key = presetCatalog.getPreset(index).key;
 
-    if (!presetFile.existsAsFile())
+    // CMake builds carry the presets as compiled tables; the XML is only read
+    // when a build has no table entry for this preset
+    if (FactoryPresets::apply(index, values))
+        return true;
+
+    auto readParams = [&values](const juce::XmlElement& parent)
+    {
+        forEachXmlChildElementWithTagName(parent, paramXml, "PARAM")
+        {
+            const auto paramIndex = ParamIds::find(paramXml->getStringAttribute("id").toRawUTF8());
+            if (paramIndex >= 0)
+                values[(size_t) paramIndex] = (float) paramXml->getDoubleAttribute("value");
+        }
+    };
+
+    const auto presetFile = resources->getImageDerivedPresetFile();
+    if (presetFile.existsAsFile())
+    {
+        if (const auto document = juce::XmlDocument::parse(presetFile))
+        {
+            forEachXmlChildElementWithTagName(*document, presetXml, "PRESET")
+            {
+                if (presetXml->getStringAttribute("key") == key)
+                {
+                    readParams(*presetXml);
+                    return true;
+                }
+            }
+        }
+    }
+
+    // Presets ImageDerived.xml does not list ship as one file each (the
+    // "Basics" category), named after the preset
+    const auto looseFile = resources->getFactoryPresetFile(presetCatalog.getPreset(index).name);
+    if (!looseFile.existsAsFile())
         return false;
 
-    const auto document = juce::XmlDocument::parse(presetFile);
+    const auto document = juce::XmlDocument::parse(looseFile);
     if (document == nullptr)
         return false;
 
-    forEachXmlChildElement(*document, presetXml)
+    readParams(*document);
+    return true;
+}
+
+bool ThreeVoicesAudioProcessor::applyUserPreset(int index)
+{
+    auto values = captureParameterValues();
+    if (!userPresets->getValues(index, values))
+        return false;
+
+    const auto before = captureParameterValues();
+    applyParameterValues(values);
+    undoHistory.recordTransaction(before, captureParameterValues());
+    return true;
+}
+
+juce::File ThreeVoicesAudioProcessor::saveUserPreset(const juce::String& name, const juce::String& category, const juce::String& tags)
+{
+    return userPresets->savePreset(name, category, tags, captureParameterValues());
+}
+
+PresetPackImporter::ParameterRanges ThreeVoicesAudioProcessor::getParameterRanges() const
+{
+    PresetPackImporter::ParameterRanges ranges;
+    for (int i = 0; i < ParamIds::numParams; ++i)
+        ranges[(size_t) i] = parameters[(size_t) i]->getNormalisableRange();
+    return ranges;
+}
+
+juce::File ThreeVoicesAudioProcessor::getPresetPackBundle(const juce::File& packDirectory) const
+{
+    return userPresets->getPackDirectory()
+        .getChildFile(juce::File::createLegalFileName(packDirectory.getFileName()) + PresetPackImporter::bundleExtension);
+}
+
+PresetPackImporter::Result ThreeVoicesAudioProcessor::importPresetPack(const juce::File& packDirectory) const
+{
+    return PresetPackImporter::importPack(packDirectory, getPresetPackBundle(packDirectory), getParameterRanges());
+}
+
+bool ThreeVoicesAudioProcessor::applyPackPreset(int pack, int presetIndex)
+{
+    auto values = captureParameterValues();
+    if (!userPresets->getPackValues(pack, presetIndex, values))
+        return false;
+
+    const auto before = captureParameterValues();
+    applyParameterValues(values);
+    undoHistory.recordTransaction(before, captureParameterValues());
+    return true;
+}
+
+bool ThreeVoicesAudioProcessor::loadCabinetImpulse(const juce::File& file)
+{
+    juce::AudioBuffer<float> source;
+    double sourceRate = 0.0;
+
+    if (file != juce::File())
     {
-        if (!presetXml->hasTagName("PRESET"))
-            continue;
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+            return false;
+
+        // Anything past the longest IR the convolvers take would be cut anyway
+        const auto maxLength = (juce::int64) std::ceil(CabinetImpulseLibrary::maxImpulseSeconds * reader->sampleRate);
+        const auto length = (int) juce::jmin(reader->lengthInSamples, maxLength);
+        source.setSize((int) juce::jlimit(1u, 2u, reader->numChannels), length);
+        reader->read(&source, 0, length, 0, true, source.getNumChannels() > 1);
+        sourceRate = reader->sampleRate;
+    }
 
-        if (presetXml->getStringAttribute("key") != key)
-            continue;
+    cabinetImpulseSource = std::move(source);
+    cabinetImpulseSourceRate = sourceRate;
+    {
+        const juce::ScopedLock sl(stateCacheLock);
+        cabinetImpulseFile = file;
+    }
 
-        forEachXmlChildElement(*presetXml, paramXml)
-        {
-            if (!paramXml->hasTagName("PARAM"))
-                continue;
+    // Before prepareToPlay there is no rate to build for; it rebuilds then
+    if (getSampleRate() > 0.0)
+        rebuildUserCabinetImpulse(getSampleRate());
+
+    stateChangeCounter.fetch_add(1, std::memory_order_release);
+    return true;
+}
 
-            const auto paramId = paramXml->getStringAttribute("id");
-            const auto value = (float) paramXml->getDoubleAttribute("value");
+juce::File ThreeVoicesAudioProcessor::getCabinetImpulseFile() const
+{
+    const juce::ScopedLock sl(stateCacheLock);
+    return cabinetImpulseFile;
+}
 
-            if (auto* parameter = apvts.getParameter(paramId))
+void ThreeVoicesAudioProcessor::rebuildUserCabinetImpulse(double sampleRate)
+{
+    auto impulse = CabinetImpulseLibrary::makeUserImpulse(cabinetImpulseSource, cabinetImpulseSourceRate, sampleRate);
+    std::vector<std::unique_ptr<PartitionedImpulse>> released;
+
+    {
+        // The audio thread picks the new impulse up at its next block and
+        // fades across to it; only impulses it no longer holds are released
+        const juce::ScopedLock sl(getCallbackLock());
+        cabinetImpulses[CabinetImpulseLibrary::user] = impulse.get();
+        if (impulse != nullptr)
+            userCabinetImpulses.push_back(std::move(impulse));
+
+        for (auto it = userCabinetImpulses.begin(); it != userCabinetImpulses.end();)
+        {
+            if (it->get() != cabinetImpulses[CabinetImpulseLibrary::user] && it->get() != activeCabinetImpulse)
+            {
+                released.push_back(std::move(*it));
+                it = userCabinetImpulses.erase(it);
+            }
+            else
             {
-                parameter->beginChangeGesture();
-                parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
-                parameter->endChangeGesture();
+                ++it;
             }
         }
+    }
+}
 
-        return true;
+void ThreeVoicesAudioProcessor::setMorphTargets(const ParameterValues& a, const ParameterValues& b)
+{
+    storeMorphEnd(0, a);
+    storeMorphEnd(1, b);
+    presetMorph.setTargets(a, b);
+}
+
+void ThreeVoicesAudioProcessor::setMorphEnd(int end)
+{
+    // While morphing the live parameters are not what is heard, so the end is
+    // taken at the current morph position
+    auto values = captureParameterValues();
+    if (presetMorph.isEnabled())
+    {
+        const auto morphed = presetMorph.evaluate(getRawValue(ParamIds::morph) * 0.01f);
+        for (int i = 0; i < ParamIds::numParams; ++i)
+            if (presetMorph.isMorphable((ParamIds::Index) i))
+                values[(size_t) i] = morphed[(size_t) i];
     }
 
-    return false;
+    storeMorphEnd(end, values);
+    if (morphEndSet[0] && morphEndSet[1])
+        presetMorph.setTargets(morphEnds[0], morphEnds[1]);
+}
+
+void ThreeVoicesAudioProcessor::storeMorphEnd(int end, const ParameterValues& values)
+{
+    {
+        const juce::ScopedLock sl(stateCacheLock);
+        morphEnds[(size_t) end] = values;
+        morphEndSet[(size_t) end] = true;
+    }
+    stateChangeCounter.fetch_add(1, std::memory_order_release);
+}
+
+bool ThreeVoicesAudioProcessor::setMorphPresets(int presetA, int presetB)
+{
+    // Both ends start from the current settings, so parameters a preset does
+    // not list hold still; the files are parsed here once, never while morphing
+    auto a = captureParameterValues();
+    auto b = a;
+    if (!resolveImageDerivedPreset(presetA, a) || !resolveImageDerivedPreset(presetB, b))
+        return false;
+
+    setMorphTargets(a, b);
+    return true;
+}
+
+void ThreeVoicesAudioProcessor::stopMorph()
+{
+    // A single stored end is simply forgotten
+    {
+        const juce::ScopedLock sl(stateCacheLock);
+        morphEndSet.fill(false);
+    }
+    stateChangeCounter.fetch_add(1, std::memory_order_release);
+
+    if (!presetMorph.isEnabled())
+        return;
+
+    // Hand the current morph position over to the live parameters so the
+    // sound does not jump when the morph is released
+    const auto live = captureParameterValues();
+    auto values = presetMorph.evaluate(getRawValue(ParamIds::morph) * 0.01f);
+    for (int i = 0; i < ParamIds::numParams; ++i)
+        if (!presetMorph.isMorphable((ParamIds::Index) i))
+            values[(size_t) i] = live[(size_t) i];
+
+    presetMorph.disable();
+    applyParameterValues(values);
+    undoHistory.recordTransaction(live, captureParameterValues());
+}
+
+void ThreeVoicesAudioProcessor::selectSnapshotSlot(int slot)
+{
+    if (slot < 0 || slot >= numSnapshotSlots || slot == activeSnapshotSlot)
+        return;
+
+    snapshotSlots[(size_t) activeSnapshotSlot] = captureParameterValues();
+    snapshotSlotFilled[(size_t) activeSnapshotSlot] = true;
+
+    // An empty slot starts as a copy of the one being left
+    if (!snapshotSlotFilled[(size_t) slot])
+    {
+        snapshotSlots[(size_t) slot] = snapshotSlots[(size_t) activeSnapshotSlot];
+        snapshotSlotFilled[(size_t) slot] = true;
+    }
+
+    activeSnapshotSlot = slot;
+    applyParameterValues(snapshotSlots[(size_t) slot]);
+}
+
+ParameterValues ThreeVoicesAudioProcessor::captureParameterValues() const noexcept
+{
+    ParameterValues values {};
+    for (int i = 0; i < ParamIds::numParams; ++i)
+        values[(size_t) i] = getRawValue((ParamIds::Index) i);
+    return values;
+}
+
+ParameterValues ThreeVoicesAudioProcessor::getDefaultParameterValues() const noexcept
+{
+    ParameterValues values {};
+    for (int i = 0; i < ParamIds::numParams; ++i)
+    {
+        const auto* parameter = parameters[(size_t) i];
+        values[(size_t) i] = parameter->convertFrom0to1(parameter->getDefaultValue());
+    }
+    return values;
+}
+
+void ThreeVoicesAudioProcessor::applyParameterValues(const ParameterValues& values)
+{
+    // Snap onto each parameter's range so the audio thread hears exactly what
+    // the APVTS will hold once the transaction completes
+    ParameterValues target = values;
+    for (int i = 0; i < ParamIds::numParams; ++i)
+    {
+        auto* parameter = parameters[(size_t) i];
+        target[(size_t) i] = parameter->convertFrom0to1(parameter->convertTo0to1(values[(size_t) i]));
+    }
+
+    parameterSnapshot.publish(target);
+
+    // Only changed parameters reach the host, and without gestures: a preset
+    // load is not a user edit, so it should not be recorded as automation
+    bool anyChanged = false;
+    for (int i = 0; i < ParamIds::numParams; ++i)
+    {
+        if (target[(size_t) i] == getRawValue((ParamIds::Index) i))
+            continue;
+
+        auto* parameter = parameters[(size_t) i];
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(target[(size_t) i]));
+        anyChanged = true;
+    }
+
+    // The voice switches must match the snapshot before the audio thread goes
+    // back to the live parameters; a bulk restore suppresses parameterChanged
+    resolvedVoiceFlags.store(resolveVoiceFlags([&target](ParamIds::Index i) { return target[(size_t) i]; }));
+    parameterSnapshot.release();
+
+    if (anyChanged)
+        updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
 }
 
 void ThreeVoicesAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
@@ -454,12 +754,50 @@ void ThreeVoicesAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
     spec.numChannels = 2;
 
+    cpuGovernor.prepare(sampleRate, (int) kRealtimeQualityLevels.size());
+    auditionPlayer.prepare(sampleRate);
+    const auto& quality = getActiveQuality();
+
     for (int i = 0; i < 3; ++i)
-    {
         voices[i].prepare(spec, i);
+
+    // Every path, dry included, is delayed to match the slowest oversampler the
+    // current profile can pick, so the latency holds across quality changes.
+    // Realtime never oversamples and reports none; offline renders pay for 4x.
+    maxOversamplingLog2 = 0;
+    if (isNonRealtime())
+        maxOversamplingLog2 = kRenderQuality.oversamplingLog2;
+    else
+        for (const auto& level : kRealtimeQualityLevels)
+            maxOversamplingLog2 = juce::jmax(maxOversamplingLog2, level.oversamplingLog2);
+
+    pathLatency = 0;
+    for (int log2 = 1; log2 <= maxOversamplingLog2; ++log2)
+        pathLatency = juce::jmax(pathLatency, voices[0].getOversamplerLatency(log2));
+    pathFadeSamples = juce::roundToInt(sampleRate * 0.005);
+    setLatencySamples(pathLatency);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        voices[i].setPathLatency(pathLatency);
+        voices[i].delayLine.setOrder(quality.interpolationOrder);
         voices[i].reset(sampleRate);
+        voices[i].oversamplingLog2 = 0;
+    }
+
+    for (auto& dryDelay : dryDelays)
+    {
+        dryDelay.prepare(pathLatency);
+        dryDelay.setDelay(pathLatency);
     }
 
+    maxChunkSize = juce::jmax(1, samplesPerBlock);
+    dryBuffer.setSize(2, maxChunkSize);
+    monoBuffer.setSize(1, maxChunkSize);
+    voiceBuffers.setSize(3, maxChunkSize);
+    driveBuffers.setSize(3, maxChunkSize);
+    transitionBuffer.setSize(1, maxChunkSize);
+
     // Initialize parameter smoothing (50ms smoothing for smooth transitions)
     const float smoothingTime = 0.05f;
     smoothedInputGain.reset(sampleRate, smoothingTime);
@@ -485,25 +823,44 @@ void ThreeVoicesAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     }
 
     // Set initial values
-    smoothedInputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(apvts.getRawParameterValue("inputGain")->load()));
-    smoothedOutputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(apvts.getRawParameterValue("outputGain")->load()));
-    smoothedMix.setCurrentAndTargetValue(apvts.getRawParameterValue("mix")->load() * 0.01f);
-    smoothedWidth.setCurrentAndTargetValue(apvts.getRawParameterValue("width")->load() * 0.01f);
+    smoothedInputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(getRawValue(ParamIds::inputGain)));
+    smoothedOutputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(getRawValue(ParamIds::outputGain)));
+    smoothedMix.setCurrentAndTargetValue(getRawValue(ParamIds::mix) * 0.01f);
+    smoothedWidth.setCurrentAndTargetValue(getRawValue(ParamIds::width) * 0.01f);
 
     // Set initial voice parameter values
     for (int i = 0; i < 3; ++i)
     {
-        juce::String prefix = "voice" + juce::String(i + 1);
-        float speed = apvts.getRawParameterValue(prefix + "Speed")->load();
-        float delayMs = apvts.getRawParameterValue(prefix + "DelayTime")->load();
-        float depth = apvts.getRawParameterValue(prefix + "Depth")->load();
-        float distortion = apvts.getRawParameterValue(prefix + "Distortion")->load();
+        float speed = getRawValue(ParamIds::forVoice(i, ParamIds::voiceSpeed));
+        float delayMs = getRawValue(ParamIds::forVoice(i, ParamIds::voiceDelayTime));
+        float depth = getRawValue(ParamIds::forVoice(i, ParamIds::voiceDepth));
+        float distortion = getRawValue(ParamIds::forVoice(i, ParamIds::voiceDistortion));
 
         voiceSmoothers[i].speed.setCurrentAndTargetValue(speed);
         voiceSmoothers[i].delayTime.setCurrentAndTargetValue(delayMs);
         voiceSmoothers[i].depth.setCurrentAndTargetValue(depth);
         voiceSmoothers[i].distortion.setCurrentAndTargetValue(distortion);
     }
+
+    // Cabinet IRs are rendered once per sample rate and shared across instances
+    for (int type = 0; type < CabinetImpulseLibrary::user; ++type)
+        cabinetImpulses[(size_t) type] = cabinetLibrary->getImpulse(type, sampleRate);
+
+    activeCabinetImpulse = nullptr;
+    rebuildUserCabinetImpulse(sampleRate);
+    activeCabinetImpulse = cabinetImpulses[(size_t) juce::jlimit(0, CabinetImpulseLibrary::numTypes - 1,
+                                                                 (int) getRawValue(ParamIds::cabType))];
+
+    for (auto& convolver : cabinetConvolvers)
+    {
+        convolver.prepare(CabinetImpulseLibrary::getMaxImpulseLength(sampleRate));
+        convolver.setImpulse(activeCabinetImpulse);
+    }
+
+    cabinetFade.reset(sampleRate, 0.02f); // 20ms fade around IR swaps
+    cabinetFade.setCurrentAndTargetValue(activeCabinetImpulse != nullptr ? 1.0f : 0.0f);
+    smoothedCabinetMix.reset(sampleRate, smoothingTime);
+    smoothedCabinetMix.setCurrentAndTargetValue(getRawValue(ParamIds::cabMix) * 0.01f);
 }
 
 void ThreeVoicesAudioProcessor::releaseResources()
@@ -599,6 +956,8 @@ void ThreeVoicesAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
     juce::ignoreUnused(midiMessages);
 
     juce::ScopedNoDenormals noDenormals;
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     const int numSamples = buffer.getNumSamples();
@@ -606,173 +965,171 @@ void ThreeVoicesAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, numSamples);
 
+    // A preset transaction in flight is read as one coherent snapshot, so a
+    // half-applied preset is never heard
+    const bool useSnapshot = parameterSnapshot.read(snapshotValues);
+    auto liveValue = [this, useSnapshot](ParamIds::Index index)
+    {
+        return useSnapshot ? snapshotValues[(size_t) index] : getRawValue(index);
+    };
+
+    // While a morph is active its interpolated values replace the live ones
+    const bool useMorph = presetMorph.process(liveValue(ParamIds::morph) * 0.01f, morphValues);
+    auto value = [this, useMorph, &liveValue](ParamIds::Index index)
+    {
+        return useMorph && presetMorph.isMorphable(index) ? morphValues[(size_t) index] : liveValue(index);
+    };
+
     // Update smoothed parameter targets
-    smoothedInputGain.setTargetValue(juce::Decibels::decibelsToGain(apvts.getRawParameterValue("inputGain")->load()));
-    smoothedOutputGain.setTargetValue(juce::Decibels::decibelsToGain(apvts.getRawParameterValue("outputGain")->load()));
-    smoothedMix.setTargetValue(apvts.getRawParameterValue("mix")->load() * 0.01f);
-    smoothedWidth.setTargetValue(apvts.getRawParameterValue("width")->load() * 0.01f);
-
-    // Read voice on/off states
-    bool voiceOn[3];
-    bool voiceTube[3], voiceBit[3];
-
-    voiceOn[0] = apvts.getRawParameterValue("voice1On")->load() > 0.5f
-              || apvts.getRawParameterValue("voice1")->load() > 0.5f;
-    voiceOn[1] = apvts.getRawParameterValue("voice2On")->load() > 0.5f
-              || apvts.getRawParameterValue("voice2")->load() > 0.5f;
-    voiceOn[2] = apvts.getRawParameterValue("voice3On")->load() > 0.5f
-              || apvts.getRawParameterValue("voice3")->load() > 0.5f;
-
-    voiceTube[0] = apvts.getRawParameterValue("voice1Tube")->load() > 0.5f
-                || apvts.getRawParameterValue("dist_tube_1")->load() > 0.5f;
-    voiceTube[1] = apvts.getRawParameterValue("voice2Tube")->load() > 0.5f
-                || apvts.getRawParameterValue("dist_tube_2")->load() > 0.5f;
-    voiceTube[2] = apvts.getRawParameterValue("voice3Tube")->load() > 0.5f
-                || apvts.getRawParameterValue("dist_tube_3")->load() > 0.5f;
-
-    voiceBit[0] = apvts.getRawParameterValue("voice1Bit")->load() > 0.5f
-               || apvts.getRawParameterValue("dist_bit_1")->load() > 0.5f;
-    voiceBit[1] = apvts.getRawParameterValue("voice2Bit")->load() > 0.5f
-               || apvts.getRawParameterValue("dist_bit_2")->load() > 0.5f;
-    voiceBit[2] = apvts.getRawParameterValue("voice3Bit")->load() > 0.5f
-               || apvts.getRawParameterValue("dist_bit_3")->load() > 0.5f;
+    smoothedInputGain.setTargetValue(juce::Decibels::decibelsToGain(value(ParamIds::inputGain)));
+    smoothedOutputGain.setTargetValue(juce::Decibels::decibelsToGain(value(ParamIds::outputGain)));
+    smoothedMix.setTargetValue(value(ParamIds::mix) * 0.01f);
+    smoothedWidth.setTargetValue(value(ParamIds::width) * 0.01f);
 
-    // Update voice parameter smoothers
+    // Read voice on/off states (legacy duplicate IDs are already merged in)
+    BlockState state;
+    state.numInputChannels = totalNumInputChannels;
+    state.numOutputChannels = totalNumOutputChannels;
+
+    const auto voiceFlags = (useSnapshot || useMorph) ? resolveVoiceFlags(value) : resolvedVoiceFlags.load();
     for (int i = 0; i < 3; ++i)
     {
-        const char* speedParam = (i == 0) ? "voice1Speed" : (i == 1) ? "voice2Speed" : "voice3Speed";
-        const char* delayParam = (i == 0) ? "voice1DelayTime" : (i == 1) ? "voice2DelayTime" : "voice3DelayTime";
-        const char* depthParam = (i == 0) ? "voice1Depth" : (i == 1) ? "voice2Depth" : "voice3Depth";
-        const char* distParam = (i == 0) ? "voice1Distortion" : (i == 1) ? "voice2Distortion" : "voice3Distortion";
+        state.voiceOn[i] = (voiceFlags & (1u << i)) != 0;
+        state.voiceTube[i] = (voiceFlags & (1u << (3 + i))) != 0;
+        state.voiceBit[i] = (voiceFlags & (1u << (6 + i))) != 0;
+    }
 
-        voiceSmoothers[i].speed.setTargetValue(apvts.getRawParameterValue(speedParam)->load());
-        voiceSmoothers[i].delayTime.setTargetValue(apvts.getRawParameterValue(delayParam)->load());
-        voiceSmoothers[i].depth.setTargetValue(apvts.getRawParameterValue(depthParam)->load());
-        voiceSmoothers[i].distortion.setTargetValue(apvts.getRawParameterValue(distParam)->load());
+    // Update voice parameter smoothers
+    for (int i = 0; i < 3; ++i)
+    {
+        voiceSmoothers[i].speed.setTargetValue(value(ParamIds::forVoice(i, ParamIds::voiceSpeed)));
+        voiceSmoothers[i].delayTime.setTargetValue(value(ParamIds::forVoice(i, ParamIds::voiceDelayTime)));
+        voiceSmoothers[i].depth.setTargetValue(value(ParamIds::forVoice(i, ParamIds::voiceDepth)));
+        voiceSmoothers[i].distortion.setTargetValue(value(ParamIds::forVoice(i, ParamIds::voiceDistortion)));
     }
 
     // Count active voices
-    int activeVoiceCount = 0;
     for (int i = 0; i < 3; ++i)
     {
-        if (voiceOn[i]) activeVoiceCount++;
+        if (state.voiceOn[i]) state.activeVoiceCount++;
     }
 
     // Set target for active gain compensation
     // When voices are active, boost by ~2dB (1.26x) to compensate for processing
-    float targetActiveGain = (activeVoiceCount > 0) ? 1.26f : 1.0f;
+    float targetActiveGain = (state.activeVoiceCount > 0) ? 1.26f : 1.0f;
     smoothedActiveGain.setTargetValue(targetActiveGain);
 
+    // Cabinet stage: fade out before swapping IRs so a type change never clicks
+    // (or loading a different user IR)
+    const int requestedCabinet = juce::jlimit(0, CabinetImpulseLibrary::numTypes - 1,
+                                              (int) value(ParamIds::cabType));
+    const auto* requestedImpulse = cabinetImpulses[(size_t) requestedCabinet];
+    if (requestedImpulse == activeCabinetImpulse)
+    {
+        cabinetFade.setTargetValue(activeCabinetImpulse != nullptr ? 1.0f : 0.0f);
+    }
+    else if (activeCabinetImpulse == nullptr || cabinetFade.getCurrentValue() <= 0.0f)
+    {
+        activeCabinetImpulse = requestedImpulse;
+        for (auto& convolver : cabinetConvolvers)
+            convolver.setImpulse(activeCabinetImpulse);
+        cabinetFade.setTargetValue(activeCabinetImpulse != nullptr ? 1.0f : 0.0f);
+    }
+    else
+    {
+        cabinetFade.setTargetValue(0.0f);
+    }
+
+    smoothedCabinetMix.setTargetValue(value(ParamIds::cabMix) * 0.01f);
+    state.cabinetActive = activeCabinetImpulse != nullptr;
+    if (!state.cabinetActive)
+        smoothedCabinetMix.skip(numSamples);
+
+    // Quality for this block: render profile offline, governor level in realtime.
+    // Voice state carries straight across a switch; the changes crossfade.
+    const bool nonRealtime = isNonRealtime();
+    const auto& quality = getActiveQuality();
+    for (auto& voice : voices)
+        voice.delayLine.setOrder(quality.interpolationOrder);
+
+    // Process in chunks no larger than the scratch buffers sized in prepareToPlay
+    for (int start = 0; start < numSamples; start += maxChunkSize)
+        processChunk(buffer, start, juce::jmin(maxChunkSize, numSamples - start), state, quality);
+
+    auditionPlayer.process(buffer);
+
+    // Offline blocks have no deadline, so they must not feed the governor
+    if (!nonRealtime)
+    {
+        const auto elapsedTicks = juce::Time::getHighResolutionTicks() - blockStartTicks;
+        cpuGovernor.update(juce::Time::highResolutionTicksToSeconds(elapsedTicks), numSamples);
+    }
+}
+
+const DspQuality& ThreeVoicesAudioProcessor::getActiveQuality() const noexcept
+{
+    if (isNonRealtime())
+        return kRenderQuality;
+
+    return kRealtimeQualityLevels[(size_t) cpuGovernor.getLevel()];
+}
+
+void ThreeVoicesAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                             const BlockState& state, const DspQuality& quality)
+{
     // Get buffer pointers
-    const float* inputL = buffer.getReadPointer(0);
-    const float* inputR = totalNumInputChannels > 1 ? buffer.getReadPointer(1) : inputL;
-    float* outputL = buffer.getWritePointer(0);
-    float* outputR = totalNumOutputChannels > 1 ? buffer.getWritePointer(1) : outputL;
+    const float* inputL = buffer.getReadPointer(0, startSample);
+    const float* inputR = state.numInputChannels > 1 ? buffer.getReadPointer(1, startSample) : inputL;
+    float* outputL = buffer.getWritePointer(0, startSample);
+    float* outputR = state.numOutputChannels > 1 ? buffer.getWritePointer(1, startSample) : outputL;
 
-    const float sampleRateFloat = static_cast<float>(currentSampleRate);
+    float* dryL = dryBuffer.getWritePointer(0);
+    float* dryR = dryBuffer.getWritePointer(1);
+    float* inMono = monoBuffer.getWritePointer(0);
 
-    // Minimum delay in samples to avoid discontinuities (about 0.5ms)
-    const float minDelaySamples = sampleRateFloat * 0.0005f;
+    // Input gain, and a mono input for consistent stereo processing
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float inputGain = smoothedInputGain.getNextValue();
+        dryL[sample] = inputL[sample] * inputGain;
+        dryR[sample] = inputR[sample] * inputGain;
+        inMono[sample] = (dryL[sample] + dryR[sample]) * 0.5f;
+    }
+
+    // The voices reach pathLatency through their distortion paths
+    dryDelays[0].process(dryL, numSamples);
+    dryDelays[1].process(dryR, numSamples);
+
+    // Each active voice renders its delayed (and optionally distorted) signal
+    for (int v = 0; v < 3; ++v)
+    {
+        if (state.voiceOn[v])
+            renderVoice(v, numSamples, state.voiceTube[v], state.voiceBit[v], quality);
+    }
+
+    const int activeVoiceCount = state.activeVoiceCount;
 
-    // Process each sample
     for (int sample = 0; sample < numSamples; ++sample)
     {
         // Get smoothed global parameters
-        float inputGain = smoothedInputGain.getNextValue();
         float outputGain = smoothedOutputGain.getNextValue();
         float mix = smoothedMix.getNextValue();
         float width = smoothedWidth.getNextValue();
         float activeGain = smoothedActiveGain.getNextValue();
 
-        // Get input samples with input gain
-        float inL = inputL[sample] * inputGain;
-        float inR = inputR[sample] * inputGain;
-
-        // Create mono input for consistent stereo processing
-        float inMono = (inL + inR) * 0.5f;
+        float inL = dryL[sample];
+        float inR = dryR[sample];
 
         float wetL = 0.0f;
         float wetR = 0.0f;
 
         for (int v = 0; v < 3; ++v)
         {
-            if (!voiceOn[v]) continue;
-
-            // Get smoothed voice parameters
-            float speed = voiceSmoothers[v].speed.getNextValue();
-            float delayMs = voiceSmoothers[v].delayTime.getNextValue();
-            float depthPercent = voiceSmoothers[v].depth.getNextValue();
-            float distortion = voiceSmoothers[v].distortion.getNextValue();
-
-            // Convert delay time from ms to samples (LINEAR mapping: 0-150ms)
-            float baseDelaySamples = delayMs * sampleRateFloat / 1000.0f;
-
-            // Depth is a FIXED modulation amount (0-10ms), NOT relative to delay
-            float maxModMs = 10.0f;
-            float modAmountMs = (depthPercent * 0.01f) * maxModMs;
-            float modAmountSamples = modAmountMs * sampleRateFloat / 1000.0f;
-
-            // Calculate UNIPOLAR LFO (0 to 1)
-            float lfo = 0.0f;
-            if (speed > 0.001f)
-            {
-                float sinValue = std::sin(voices[v].phase * juce::MathConstants<float>::twoPi);
-                lfo = (sinValue + 1.0f) * 0.5f;
-
-                voices[v].phase += speed / sampleRateFloat;
-                if (voices[v].phase >= 1.0f) voices[v].phase -= 1.0f;
-            }
-
-            // Final delay = base delay + LFO modulation
-            float delayTimeSamples = baseDelaySamples + lfo * modAmountSamples;
-
-            // Clamp to valid range
-            float maxDelay = sampleRateFloat * 0.16f;
-            delayTimeSamples = juce::jlimit(0.0f, maxDelay, delayTimeSamples);
-
-            // Always push to delay line
-            voices[v].delayLine.pushSample(0, inMono);
-
-            // FIXED: Crossfade between dry and delayed to eliminate clicks at zero delay
-            // Instead of switching abruptly, we blend based on delay amount
-            float delayedSample;
-
-            if (delayTimeSamples < minDelaySamples)
-            {
-                // Very low delay: use dry signal (no audible delay)
-                delayedSample = inMono;
-                // But still read from delay line to keep it flowing
-                voices[v].delayLine.popSample(0, minDelaySamples);
-            }
-            else if (delayTimeSamples < minDelaySamples * 2.0f)
-            {
-                // Crossfade zone: blend between dry and delayed
-                float crossfade = (delayTimeSamples - minDelaySamples) / minDelaySamples;
-                float delayed = voices[v].delayLine.popSample(0, delayTimeSamples);
-                delayedSample = inMono * (1.0f - crossfade) + delayed * crossfade;
-            }
-            else
-            {
-                // Normal delay operation
-                delayedSample = voices[v].delayLine.popSample(0, delayTimeSamples);
-            }
-
-            // Apply distortion if enabled
-            if (voiceTube[v] || voiceBit[v])
-            {
-                if (voiceTube[v])
-                {
-                    delayedSample = processTubeDistortion(delayedSample, distortion);
-                }
-                if (voiceBit[v])
-                {
-                    delayedSample = processBitCrusher(delayedSample, distortion);
-                }
-            }
+            if (!state.voiceOn[v]) continue;
 
             // Start with equal L/R (center panned)
-            float voiceL = delayedSample;
-            float voiceR = delayedSample;
+            float voiceL = voiceBuffers.getSample(v, sample);
+            float voiceR = voiceL;
 
             // Apply panning ONLY if 2+ voices AND width > 0
             if (activeVoiceCount >= 2 && width > 0.001f)
@@ -784,7 +1141,7 @@ void ThreeVoicesAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
                     int activeIndex = 0;
                     for (int check = 0; check <= v; ++check)
                     {
-                        if (voiceOn[check]) activeIndex++;
+                        if (state.voiceOn[check]) activeIndex++;
                     }
                     panPos = (activeIndex == 1) ? -width : width;
                 }
@@ -812,6 +1169,17 @@ void ThreeVoicesAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
             wetR *= norm;
         }
 
+        // Cabinet / room convolution on the voice sum (keeps running while fading
+        // so the IR tail rings out naturally)
+        if (state.cabinetActive)
+        {
+            float cabinetAmount = smoothedCabinetMix.getNextValue() * cabinetFade.getNextValue();
+            float cabL = cabinetConvolvers[0].processSample(wetL);
+            float cabR = cabinetConvolvers[1].processSample(wetR);
+            wetL += (cabL - wetL) * cabinetAmount;
+            wetR += (cabR - wetR) * cabinetAmount;
+        }
+
         // Mix dry/wet
         float outL, outR;
         if (activeVoiceCount == 0)
@@ -835,11 +1203,184 @@ void ThreeVoicesAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
 
         // Apply soft limiter to prevent clipping
         outputL[sample] = softLimit(outL);
-        if (totalNumOutputChannels > 1)
+        if (state.numOutputChannels > 1)
             outputR[sample] = softLimit(outR);
     }
 }
 
+void ThreeVoicesAudioProcessor::renderVoice(int v, int numSamples, bool tube, bool bit, const DspQuality& quality)
+{
+    auto& voice = voices[v];
+    auto& smoothers = voiceSmoothers[v];
+    const float* inMono = monoBuffer.getReadPointer(0);
+    float* voiceOut = voiceBuffers.getWritePointer(v);
+    float* drive = driveBuffers.getWritePointer(v);
+
+    const float sampleRateFloat = static_cast<float>(currentSampleRate);
+
+    // Minimum delay in samples to avoid discontinuities (about 0.5ms)
+    const float minDelaySamples = sampleRateFloat * 0.0005f;
+    const float maxDelay = sampleRateFloat * 0.16f;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // Control-rate update: the LFO and smoothers advance a whole interval at once
+        // and the delay ramps linearly to the new target (interval 1 = audio rate)
+        if (voice.controlCountdown <= 0)
+        {
+            const int interval = juce::jmax(1, quality.controlInterval);
+
+            float speed = smoothers.speed.skip(interval);
+            float delayMs = smoothers.delayTime.skip(interval);
+            float depthPercent = smoothers.depth.skip(interval);
+
+            // Convert delay time from ms to samples (LINEAR mapping: 0-150ms)
+            float baseDelaySamples = delayMs * sampleRateFloat / 1000.0f;
+
+            // Depth is a FIXED modulation amount (0-10ms), NOT relative to delay
+            float maxModMs = 10.0f;
+            float modAmountMs = (depthPercent * 0.01f) * maxModMs;
+            float modAmountSamples = modAmountMs * sampleRateFloat / 1000.0f;
+
+            // Calculate UNIPOLAR LFO (0 to 1)
+            float lfo = 0.0f;
+            if (speed > 0.001f)
+            {
+                float sinValue = std::sin(voice.phase * juce::MathConstants<float>::twoPi);
+                lfo = (sinValue + 1.0f) * 0.5f;
+
+                voice.phase += speed * (float) interval / sampleRateFloat;
+                while (voice.phase >= 1.0f) voice.phase -= 1.0f;
+            }
+
+            // Final delay = base delay + LFO modulation, clamped to valid range
+            float targetDelay = juce::jlimit(0.0f, maxDelay, baseDelaySamples + lfo * modAmountSamples);
+            voice.delayStep = (targetDelay - voice.currentDelay) / (float) interval;
+            voice.controlCountdown = interval;
+        }
+
+        voice.currentDelay += voice.delayStep;
+        --voice.controlCountdown;
+        const float delayTimeSamples = voice.currentDelay;
+        const float input = inMono[sample];
+
+        // Always push to delay line
+        voice.delayLine.pushSample(input);
+
+        // Crossfade between dry and delayed to eliminate clicks at zero delay
+        float delayedSample;
+
+        if (delayTimeSamples < minDelaySamples)
+        {
+            // Very low delay: use dry signal (no audible delay)
+            delayedSample = input;
+        }
+        else if (delayTimeSamples < minDelaySamples * 2.0f)
+        {
+            // Crossfade zone: blend between dry and delayed
+            float crossfade = (delayTimeSamples - minDelaySamples) / minDelaySamples;
+            float delayed = voice.delayLine.popSample(delayTimeSamples);
+            delayedSample = input * (1.0f - crossfade) + delayed * crossfade;
+        }
+        else
+        {
+            // Normal delay operation
+            delayedSample = voice.delayLine.popSample(delayTimeSamples);
+        }
+
+        voiceOut[sample] = delayedSample;
+        drive[sample] = smoothers.distortion.getNextValue();
+    }
+
+    // Voices without distortion take the 1x path unshaped, so every voice has the same latency.
+    // A host that switches to offline without re-preparing keeps the paths it was prepared for.
+    const int oversamplingLog2 = juce::jmin(quality.oversamplingLog2, maxOversamplingLog2);
+    applyVoiceDistortion(v, numSamples, tube, bit, (tube || bit) ? oversamplingLog2 : 0);
+}
+
+void ThreeVoicesAudioProcessor::applyVoiceDistortion(int v, int numSamples, bool tube, bool bit, int oversamplingLog2)
+{
+    auto& voice = voices[v];
+    float* samples = voiceBuffers.getWritePointer(v);
+    const float* drive = driveBuffers.getReadPointer(v);
+
+    // A new path starts empty, so the old one keeps playing until the new one
+    // has filled up to pathLatency, then the two (time-aligned) paths crossfade.
+    // A change that arrives during a switch waits for it to finish.
+    if (oversamplingLog2 != voice.oversamplingLog2 && voice.fadingFromLog2 < 0)
+    {
+        voice.fadingFromLog2 = voice.oversamplingLog2;
+        voice.oversamplingLog2 = oversamplingLog2;
+        voice.transitionPosition = 0;
+        resetDistortionPath(voice, oversamplingLog2);
+    }
+
+    if (voice.fadingFromLog2 < 0)
+    {
+        distortVoiceBlock(voice, samples, drive, numSamples, tube, bit, voice.oversamplingLog2);
+        return;
+    }
+
+    float* previous = transitionBuffer.getWritePointer(0);
+    std::copy(samples, samples + numSamples, previous);
+    distortVoiceBlock(voice, previous, drive, numSamples, tube, bit, voice.fadingFromLog2);
+    distortVoiceBlock(voice, samples, drive, numSamples, tube, bit, voice.oversamplingLog2);
+
+    const int fadeLength = juce::jmax(1, pathFadeSamples);
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const auto position = voice.transitionPosition + sample + 1 - pathLatency;
+        const float t = juce::jlimit(0.0f, 1.0f, (float) position / (float) fadeLength);
+        samples[sample] = previous[sample] + (samples[sample] - previous[sample]) * t;
+    }
+
+    voice.transitionPosition += numSamples;
+    if (voice.transitionPosition >= pathLatency + fadeLength)
+        voice.fadingFromLog2 = -1;
+}
+
+void ThreeVoicesAudioProcessor::resetDistortionPath(VoiceProcessor& voice, int oversamplingLog2)
+{
+    if (oversamplingLog2 > 0)
+        voice.oversamplers[(size_t) oversamplingLog2 - 1]->reset();
+    voice.pathDelays[(size_t) oversamplingLog2].reset();
+}
+
+void ThreeVoicesAudioProcessor::distortVoiceBlock(VoiceProcessor& voice, float* samples, const float* drive,
+                                                  int numSamples, bool tube, bool bit, int oversamplingLog2)
+{
+    auto shape = [this, tube, bit](float x, float amount)
+    {
+        if (tube) x = processTubeDistortion(x, amount);
+        if (bit)  x = processBitCrusher(x, amount);
+        return x;
+    };
+
+    if (oversamplingLog2 <= 0)
+    {
+        if (tube || bit)
+            for (int sample = 0; sample < numSamples; ++sample)
+                samples[sample] = shape(samples[sample], drive[sample]);
+    }
+    else
+    {
+        auto& oversampler = *voice.oversamplers[(size_t) oversamplingLog2 - 1];
+        float* channels[] = { samples };
+        juce::dsp::AudioBlock<float> block(channels, 1, (size_t) numSamples);
+
+        auto upsampled = oversampler.processSamplesUp(block);
+        float* up = upsampled.getChannelPointer(0);
+        const auto numUpsampled = upsampled.getNumSamples();
+
+        for (size_t i = 0; i < numUpsampled; ++i)
+            up[i] = shape(up[i], drive[i >> oversamplingLog2]);
+
+        oversampler.processSamplesDown(block);
+    }
+
+    voice.pathDelays[(size_t) oversamplingLog2].process(samples, numSamples);
+}
+
 // FIXED: Correct constant-power panning
 void ThreeVoicesAudioProcessor::applyConstantPowerPan(float& left, float& right, float panPosition)
 {
@@ -889,9 +1430,27 @@ juce::AudioProcessorEditor* ThreeVoicesAudioProcessor::createEditor()
 
 void ThreeVoicesAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Hosts ask on every autosave tick; re-serialise only after a change.
+    // The counter is read before the values, so a change racing with the
+    // capture leaves the cache stale-tagged and it is rebuilt next time.
+    const juce::ScopedLock sl(stateCacheLock);
+    const auto changeCount = stateChangeCounter.load(std::memory_order_acquire);
+
+    if (changeCount != cachedStateChangeCount || cachedState.isEmpty())
+    {
+        juce::StringPairArray properties;
+        if (cabinetImpulseFile != juce::File())
+            properties.set("cabinetImpulse", cabinetImpulseFile.getFullPathName());
+        if (morphEndSet[0])
+            properties.set("morphA", encodeParameterValues(morphEnds[0]));
+        if (morphEndSet[1])
+            properties.set("morphB", encodeParameterValues(morphEnds[1]));
+
+        BinaryState::write(captureParameterValues(), cachedState, properties);
+        cachedStateChangeCount = changeCount;
+    }
+
+    destData = cachedState;
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -3,7 +3,25 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
-class ThreeVoicesAudioProcessor : public juce::AudioProcessor
+#include "dsp/AuditionPlayer.h"
+#include "dsp/CabinetImpulseLibrary.h"
+#include "dsp/CompensationDelay.h"
+#include "dsp/CpuLoadGovernor.h"
+#include "dsp/DspQuality.h"
+#include "dsp/FractionalDelayLine.h"
+#include "presets/PresetCatalog.h"
+#include "presets/PresetPackImporter.h"
+#include "presets/ResourceLocator.h"
+#include "presets/UserPresetStore.h"
+#include "state/BinaryState.h"
+#include "state/ParameterIds.h"
+#include "state/ParameterSnapshot.h"
+#include "state/ParameterUndoHistory.h"
+#include "state/PresetMorph.h"
+
+class ThreeVoicesAudioProcessor : public juce::AudioProcessor,
+                                  private juce::AudioProcessorValueTreeState::Listener,
+                                  private juce::AudioProcessorParameter::Listener
 {
 public:
     ThreeVoicesAudioProcessor();
@@ -38,42 +56,197 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
-    const juce::StringArray& getFlattenedPresetChoices() const noexcept { return flattenedPresetChoices; }
+    const PresetCatalog& getPresetCatalog() const noexcept { return presetCatalog; }
     int getCurrentPresetIndex() const;
     void setCurrentPresetIndex(int index);
     bool applyImageDerivedPreset(int index);
 
+    // Message thread. Current value of every parameter, and a transactional
+    // apply: the audio thread switches to the complete snapshot at once, then
+    // the live parameters are updated without per-parameter gestures.
+    ParameterValues captureParameterValues() const noexcept;
+    ParameterValues getDefaultParameterValues() const noexcept;
+    void applyParameterValues(const ParameterValues& values);
+
+    // Bulk restore used by setStateInformation: like applyParameterValues, but
+    // per-parameter listener work is suspended and stateGeneration is bumped once.
+    void restoreParameterValues(const ParameterValues& values);
+    bool isRestoringState() const noexcept { return bulkRestoreInProgress.load(); }
+    juce::uint32 getStateGeneration() const noexcept { return stateGeneration.load(); }
+
+    // Parameter undo/redo (message thread). Gestures and preset loads are
+    // recorded; host automation and state restores are not.
+    bool undo();
+    bool redo();
+    ParameterUndoHistory& getUndoHistory() noexcept { return undoHistory; }
+
+    // Preset morphing (message thread). While a morph is active the DSP follows
+    // the "morph" parameter between snapshots A and B instead of the live
+    // parameters; stopMorph() writes the current morph position back to them.
+    // setMorphEnd() stores what is currently heard as end A (0) or B (1) and
+    // starts the morph once both ends are set. The ends are saved in the state.
+    void setMorphTargets(const ParameterValues& a, const ParameterValues& b);
+    bool setMorphPresets(int presetA, int presetB);
+    void setMorphEnd(int end);
+    bool hasMorphEnd(int end) const noexcept { return morphEndSet[(size_t) end]; }
+    void stopMorph();
+    bool isMorphing() const noexcept { return presetMorph.isEnabled(); }
+
+    // A/B/C/D compare slots held as resolved parameter arrays (message thread).
+    // Selecting a slot stores the current settings into the active one and
+    // applies the target as a single transaction: no file or XML work.
+    static constexpr int numSnapshotSlots = 4;
+    void selectSnapshotSlot(int slot);
+    int getActiveSnapshotSlot() const noexcept { return activeSnapshotSlot; }
+
+    // User presets (message thread), served from the store's memory-mapped index.
+    // Loading one is a transaction like a factory preset, and can be undone.
+    UserPresetStore& getUserPresets() noexcept { return *userPresets; }
+    bool applyUserPreset(int index);
+    juce::File saveUserPreset(const juce::String& name, const juce::String& category = {}, const juce::String& tags = {});
+
+    // Imports a third-party pack folder into getPresetPackBundle(), clamped to
+    // this processor's parameter ranges. Blocks while the pack is parsed in
+    // parallel, so the editor runs it on a background thread; the store maps
+    // the bundle once it is written and applyPackPreset() loads from it.
+    juce::File getPresetPackBundle(const juce::File& packDirectory) const;
+    PresetPackImporter::Result importPresetPack(const juce::File& packDirectory) const;
+    bool applyPackPreset(int pack, int presetIndex);
+    PresetPackImporter::ParameterRanges getParameterRanges() const;
+
+    // User cabinet IR (message thread), used while "cabType" is "User IR".
+    // Reads the file, keeps the first CabinetImpulseLibrary::maxImpulseSeconds
+    // and swaps it in under the callback lock; the path is saved in the state.
+    // A default juce::File unloads it.
+    bool loadCabinetImpulse(const juce::File& file);
+    juce::File getCabinetImpulseFile() const;
+
+    // Preset previews rendered by AuditionRenderer replace the output while
+    // one is playing; the live parameters and DSP state are left alone.
+    AuditionPlayer& getAuditionPlayer() noexcept { return auditionPlayer; }
+
+    // Realtime quality governor: steps interpolation, oversampling and control
+    // rate down under sustained CPU load. Safe to call from the message thread.
+    CpuLoadGovernor& getCpuGovernor() noexcept { return cpuGovernor; }
+
 private:
-    bool applyImageDerivedPreset(const juce::String& flattenedChoice);
+    bool resolveImageDerivedPreset(int index, ParameterValues& values) const;
+
+    // Shared by every instance; keeps the memoised file lookups alive
+    juce::SharedResourcePointer<ResourceLocator> resources;
+
+    // Declared before apvts: createParameterLayout() reads the preset names
+    const PresetCatalog presetCatalog;
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    juce::StringArray flattenedPresetChoices;
-    static juce::StringArray createFlattenedPresetChoices();
+
+    // Every parameter resolved once at construction, indexed by ParamIds::Index
+    std::array<juce::RangedAudioParameter*, ParamIds::numParams> parameters {};
+    std::array<std::atomic<float>*, ParamIds::numParams> rawParams {};
+    float getRawValue(ParamIds::Index index) const noexcept { return rawParams[(size_t) index]->load(); }
+
+    // On/Tube/Bit per voice with the legacy duplicates already ORed in.
+    // Bit v = on, bit 3 + v = tube, bit 6 + v = bit. Kept current by parameterChanged.
+    std::atomic<juce::uint32> resolvedVoiceFlags { 0 };
+
+    // Bumped by parameterChanged; getStateInformation reuses cachedState while it is unchanged
+    std::atomic<juce::uint64> stateChangeCounter { 0 };
+    juce::CriticalSection stateCacheLock;
+    juce::MemoryBlock cachedState;
+    juce::uint64 cachedStateChangeCount = 0;
+
+    // AudioProcessorParameter::Listener: gestures feed the undo history
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
+    ParameterUndoHistory undoHistory;
+
+    std::atomic<bool> bulkRestoreInProgress { false };
+    std::atomic<juce::uint32> stateGeneration { 0 }; // bumped once per restored state
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    ParameterSnapshotExchange parameterSnapshot;
+    ParameterValues snapshotValues {}; // audio thread copy of the published snapshot
+
+    std::array<ParameterValues, numSnapshotSlots> snapshotSlots {};
+    std::array<bool, numSnapshotSlots> snapshotSlotFilled {};
+    int activeSnapshotSlot = 0;
+
+    // One store and watcher for every instance in the process
+    juce::SharedResourcePointer<UserPresetStore> userPresets;
+
+    PresetMorph presetMorph;
+    ParameterValues morphValues {}; // audio thread, this block's morphed values
+    std::array<ParameterValues, 2> morphEnds {}; // written under stateCacheLock
+    std::array<bool, 2> morphEndSet {};
+    void storeMorphEnd(int end, const ParameterValues& values);
 
     // Voice processing - mono delay line with Lagrange interpolation
     struct VoiceProcessor
     {
         float phase = 0.0f;
-        // Lagrange interpolation for smooth, click-free delay changes
+        // Switchable Lagrange order for smooth, click-free delay changes
         // Single channel - we process mono and create stereo via panning
-        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> delayLine{ 32000 };
+        FractionalDelayLine delayLine;
+
+        // Control-rate state: the delay ramps linearly between control ticks
+        float currentDelay = 0.0f;
+        float delayStep = 0.0f;
+        int controlCountdown = 0;
+
+        // Distortion paths: 1x, then linear-phase oversamplers for 2x and 4x.
+        // Each path is padded to the same latency by its compensation delay,
+        // so switching paths crossfades two time-aligned signals.
+        std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, DspQuality::maxOversamplingLog2> oversamplers;
+        std::array<CompensationDelay, DspQuality::maxOversamplingLog2 + 1> pathDelays;
+        int oversamplingLog2 = 0;      // path in use
+        int fadingFromLog2 = -1;       // previous path while a switch is in progress
+        int transitionPosition = 0;    // samples into the switch
 
         void prepare(const juce::dsp::ProcessSpec& spec, int /*voiceIndex*/)
         {
             // Max delay: 170ms at current sample rate (150ms + modulation headroom)
             int maxDelaySamples = static_cast<int>(spec.sampleRate * 0.17f) + 64;
-            delayLine.setMaximumDelayInSamples(maxDelaySamples);
+            delayLine.prepare(maxDelaySamples);
+
+            for (int i = 0; i < DspQuality::maxOversamplingLog2; ++i)
+            {
+                oversamplers[(size_t) i] = std::make_unique<juce::dsp::Oversampling<float>>(
+                    1, (size_t) i + 1, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+                oversamplers[(size_t) i]->initProcessing(spec.maximumBlockSize);
+            }
+        }
 
-            // Prepare as mono (1 channel) - stereo is handled via panning
-            juce::dsp::ProcessSpec monoSpec = spec;
-            monoSpec.numChannels = 1;
-            delayLine.prepare(monoSpec);
+        int getOversamplerLatency(int log2) const noexcept
+        {
+            return log2 > 0 ? juce::roundToInt(oversamplers[(size_t) log2 - 1]->getLatencyInSamples()) : 0;
+        }
+
+        // Pads every path to pathLatency, the latency of the slowest oversampler
+        // in use; slower paths are never selected and get no padding
+        void setPathLatency(int pathLatency)
+        {
+            for (int i = 0; i <= DspQuality::maxOversamplingLog2; ++i)
+            {
+                pathDelays[(size_t) i].prepare(pathLatency);
+                pathDelays[(size_t) i].setDelay(juce::jmax(0, pathLatency - getOversamplerLatency(i)));
+            }
         }
 
         void reset(double /*sampleRate*/)
         {
             phase = 0.0f;
             delayLine.reset();
+            currentDelay = 0.0f;
+            delayStep = 0.0f;
+            controlCountdown = 0;
+
+            for (auto& oversampler : oversamplers)
+                if (oversampler != nullptr)
+                    oversampler->reset();
+            for (auto& pathDelay : pathDelays)
+                pathDelay.reset();
+            fadingFromLog2 = -1;
+            transitionPosition = 0;
         }
     };
 
@@ -106,11 +279,68 @@ private:
     // Soft limiter to prevent clipping
     float softLimit(float sample);
 
+    // Per-block switches shared by every chunk of a processBlock call
+    struct BlockState
+    {
+        bool voiceOn[3] = { false, false, false };
+        bool voiceTube[3] = { false, false, false };
+        bool voiceBit[3] = { false, false, false };
+        int activeVoiceCount = 0;
+        bool cabinetActive = false;
+        int numInputChannels = 0;
+        int numOutputChannels = 0;
+    };
+
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                      const BlockState& state, const DspQuality& quality);
+    void renderVoice(int voiceIndex, int numSamples, bool tube, bool bit, const DspQuality& quality);
+    void applyVoiceDistortion(int voiceIndex, int numSamples, bool tube, bool bit, int oversamplingLog2);
+    void resetDistortionPath(VoiceProcessor& voice, int oversamplingLog2);
+    void distortVoiceBlock(VoiceProcessor& voice, float* samples, const float* drive,
+                           int numSamples, bool tube, bool bit, int oversamplingLog2);
+
+    // Scratch buffers for chunked processing, sized in prepareToPlay
+    int maxChunkSize = 0;
+    juce::AudioBuffer<float> dryBuffer;        // 2 channels, input after input gain
+    juce::AudioBuffer<float> monoBuffer;       // mono sum fed to the voices
+    juce::AudioBuffer<float> voiceBuffers;     // one channel per voice
+    juce::AudioBuffer<float> driveBuffers;     // smoothed distortion amount per voice
+    juce::AudioBuffer<float> transitionBuffer; // old distortion path during a path switch
+
+    // Every voice path and the dry signal run this late (reported to the host).
+    // Zero in realtime; the oversampled paths are only prepared for offline renders.
+    int pathLatency = 0;
+    int maxOversamplingLog2 = 0; // highest path padded to pathLatency
+    int pathFadeSamples = 0; // crossfade length once a new path has filled up
+    CompensationDelay dryDelays[2];
+
+    CpuLoadGovernor cpuGovernor;
+    AuditionPlayer auditionPlayer;
+
+    // Render profile while bouncing offline, otherwise the governor's realtime level
+    const DspQuality& getActiveQuality() const noexcept;
+
     // Gain compensation for active voices (smoothed)
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedActiveGain;
 
     // Previous delay values for crossfade (per voice)
     float prevDelayTimeSamples[3] = { 0.0f, 0.0f, 0.0f };
 
+    // Cabinet / room convolution after the voice sum (IRs shared across instances)
+    juce::SharedResourcePointer<CabinetImpulseLibrary> cabinetLibrary;
+    std::array<const PartitionedImpulse*, CabinetImpulseLibrary::numTypes> cabinetImpulses {};
+    PartitionedConvolver cabinetConvolvers[2];
+    const PartitionedImpulse* activeCabinetImpulse = nullptr; // what the convolvers hold
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> cabinetFade; // ramps around IR swaps
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedCabinetMix;
+
+    // The loaded user IR at its file rate, re-partitioned whenever the sample
+    // rate changes. Replaced impulses stay alive until the convolvers let go.
+    juce::File cabinetImpulseFile;
+    juce::AudioBuffer<float> cabinetImpulseSource;
+    double cabinetImpulseSourceRate = 0.0;
+    std::vector<std::unique_ptr<PartitionedImpulse>> userCabinetImpulses;
+    void rebuildUserCabinetImpulse(double sampleRate);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThreeVoicesAudioProcessor)
 };
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Plays a pre-rendered preset preview in place of the plugin's output, so a
+// preset can be heard without touching the live parameters or DSP state.
+//
+// The message thread hands over a clip already at the playback sample rate;
+// the audio thread fades out whatever is playing, swaps the clip in and fades
+// it up over the processed signal, looping it until stop(). Clips are only
+// ever freed on the message thread: a replaced clip is parked in "retired"
+// and released by the next play() or stop().
+class AuditionPlayer
+{
+public:
+    static constexpr double fadeSeconds = 0.02;
+
+    void prepare(double sampleRate) noexcept
+    {
+        fadeStep = (float) (1.0 / juce::jmax(1.0, fadeSeconds * sampleRate));
+    }
+
+    // Message thread.
+    void play(std::unique_ptr<juce::AudioBuffer<float>> clip)
+    {
+        request(std::move(clip));
+    }
+
+    void stop()
+    {
+        request(nullptr);
+    }
+
+    bool isPlaying() const noexcept { return playing.load(); }
+
+    // Audio thread. Crossfades the block towards the clip while auditioning.
+    void process(juce::AudioBuffer<float>& buffer) noexcept
+    {
+        // The message thread only holds the lock for a pointer swap; if it is
+        // mid-swap the change is simply picked up next block
+        const juce::SpinLock::ScopedTryLockType sl(lock);
+        if (!sl.isLocked() || (current == nullptr && !hasPending))
+            return;
+
+        const int numChannels = buffer.getNumChannels();
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            if (hasPending && gain <= 0.0f)
+            {
+                jassert(retired == nullptr);
+                retired = std::move(current);
+                current = std::move(pending);
+                hasPending = false;
+                position = 0;
+                playing.store(current != nullptr);
+            }
+
+            if (current == nullptr)
+                break;
+
+            const float target = hasPending ? 0.0f : 1.0f;
+            gain = target > gain ? juce::jmin(target, gain + fadeStep) : juce::jmax(target, gain - fadeStep);
+
+            const int clipChannels = current->getNumChannels();
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* samples = buffer.getWritePointer(ch);
+                const float clipSample = current->getSample(juce::jmin(ch, clipChannels - 1), position);
+                samples[i] += gain * (clipSample - samples[i]);
+            }
+
+            if (++position >= current->getNumSamples())
+                position = 0;
+        }
+    }
+
+private:
+    void request(std::unique_ptr<juce::AudioBuffer<float>> clip)
+    {
+        if (clip != nullptr && (clip->getNumSamples() == 0 || clip->getNumChannels() == 0))
+            clip.reset();
+
+        // Freed after the lock is released
+        std::unique_ptr<juce::AudioBuffer<float>> previousPending, previousRetired;
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            previousRetired = std::move(retired);
+            previousPending = std::move(pending);
+            pending = std::move(clip);
+            hasPending = true;
+        }
+    }
+
+    juce::SpinLock lock;
+    std::unique_ptr<juce::AudioBuffer<float>> current, pending, retired;
+    bool hasPending = false;
+    std::atomic<bool> playing { false };
+
+    // Audio thread
+    int position = 0;
+    float gain = 0.0f;
+    float fadeStep = 0.001f;
+};
@@ -0,0 +1,140 @@
+#include "CabinetImpulseLibrary.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+struct CabinetVoicing
+{
+    double seconds;       // IR length
+    double decaySeconds;  // exponential decay time constant of the diffuse part
+    double highPassHz;
+    double lowPassHz;
+    double resonanceHz;   // low cabinet / room mode
+    float  resonanceGain;
+    double presenceHz;    // speaker cone presence peak
+    float  presenceGain;
+};
+
+CabinetVoicing getVoicing(int type)
+{
+    switch (type)
+    {
+        case CabinetImpulseLibrary::closedBack1x12: return { 0.045, 0.006, 80.0, 5200.0, 110.0, 2.0f,  2400.0, 1.6f };
+        case CabinetImpulseLibrary::openBack4x12:   return { 0.080, 0.012, 60.0, 4200.0,  95.0, 1.8f,  1800.0, 1.4f };
+        case CabinetImpulseLibrary::smallRoom:      return { CabinetImpulseLibrary::maxImpulseSeconds,
+                                                             0.070, 40.0, 9000.0, 180.0, 1.1f,  3000.0, 1.0f };
+        default:                                    return { 0.0, 0.0, 0.0, 0.0, 0.0, 1.0f, 0.0, 1.0f };
+    }
+}
+} // namespace
+
+juce::StringArray CabinetImpulseLibrary::getTypeNames()
+{
+    return { "Off", "Closed 1x12", "Open 4x12", "Small Room", "User IR" };
+}
+
+int CabinetImpulseLibrary::getMaxImpulseLength(double sampleRate) noexcept
+{
+    return (int) std::ceil(maxImpulseSeconds * sampleRate);
+}
+
+const PartitionedImpulse* CabinetImpulseLibrary::getImpulse(int type, double sampleRate)
+{
+    if (type <= off || type >= user)
+        return nullptr;
+
+    const juce::ScopedLock sl(lock);
+
+    for (const auto& entry : entries)
+        if (entry.type == type && entry.sampleRate == sampleRate)
+            return entry.impulse.get();
+
+    const auto samples = renderImpulse(type, sampleRate);
+    entries.push_back({ type, sampleRate, std::make_unique<PartitionedImpulse>(samples.data(), (int) samples.size()) });
+    return entries.back().impulse.get();
+}
+
+std::vector<float> CabinetImpulseLibrary::renderImpulse(int type, double sampleRate)
+{
+    const auto voicing = getVoicing(type);
+    const int length = juce::jlimit(1, getMaxImpulseLength(sampleRate), (int) std::ceil(voicing.seconds * sampleRate));
+    std::vector<float> impulse((size_t) length, 0.0f);
+
+    // Direct sound plus a decaying diffuse tail; fixed seed keeps every instance
+    // and every session bit-identical.
+    juce::Random random(0x3c4b + type);
+    const double decaySamples = juce::jmax(1.0, voicing.decaySeconds * sampleRate);
+    impulse[0] = 1.0f;
+    for (int n = 1; n < length; ++n)
+        impulse[(size_t) n] = (random.nextFloat() * 2.0f - 1.0f) * (float) std::exp(-n / decaySamples) * 0.5f;
+
+    const double nyquistLimit = sampleRate * 0.45;
+    juce::IIRFilter highPass, lowPass, resonance, presence;
+    highPass.setCoefficients(juce::IIRCoefficients::makeHighPass(sampleRate, voicing.highPassHz, 0.707));
+    lowPass.setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, juce::jmin(voicing.lowPassHz, nyquistLimit), 0.707));
+    resonance.setCoefficients(juce::IIRCoefficients::makePeakFilter(sampleRate, voicing.resonanceHz, 1.2, voicing.resonanceGain));
+    presence.setCoefficients(juce::IIRCoefficients::makePeakFilter(sampleRate, juce::jmin(voicing.presenceHz, nyquistLimit), 0.9, voicing.presenceGain));
+
+    for (auto* filter : { &highPass, &lowPass, &resonance, &presence })
+        filter->processSamples(impulse.data(), length);
+
+    fadeAndNormalise(impulse);
+    return impulse;
+}
+
+std::unique_ptr<PartitionedImpulse> CabinetImpulseLibrary::makeUserImpulse(const juce::AudioBuffer<float>& source,
+                                                                           double sourceSampleRate, double sampleRate)
+{
+    const int numChannels = source.getNumChannels();
+    const int sourceLength = source.getNumSamples();
+    if (numChannels == 0 || sourceLength == 0 || sourceSampleRate <= 0.0 || sampleRate <= 0.0)
+        return nullptr;
+
+    std::vector<float> mono((size_t) sourceLength, 0.0f);
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::addWithMultiply(mono.data(), source.getReadPointer(channel),
+                                                     1.0f / (float) numChannels, sourceLength);
+
+    const double ratio = sourceSampleRate / sampleRate;
+    const int length = juce::jlimit(1, getMaxImpulseLength(sampleRate), (int) std::ceil(sourceLength / ratio));
+    std::vector<float> impulse((size_t) length, 0.0f);
+
+    if (ratio == 1.0)
+    {
+        std::copy(mono.begin(), mono.begin() + length, impulse.begin());
+    }
+    else
+    {
+        // Pad the source so the interpolator can read past its last sample
+        mono.resize((size_t) sourceLength + 8, 0.0f);
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process(ratio, mono.data(), impulse.data(), length);
+    }
+
+    fadeAndNormalise(impulse);
+    return std::make_unique<PartitionedImpulse>(impulse.data(), length);
+}
+
+void CabinetImpulseLibrary::fadeAndNormalise(std::vector<float>& impulse)
+{
+    const int length = (int) impulse.size();
+
+    // Short fade so truncating the tail never adds a click of its own.
+    const int fadeLength = juce::jmax(1, length / 20);
+    for (int n = 0; n < fadeLength; ++n)
+        impulse[(size_t) (length - 1 - n)] *= (float) n / (float) fadeLength;
+
+    // Unity energy gain so switching IRs does not jump in level.
+    double energy = 0.0;
+    for (const auto sample : impulse)
+        energy += (double) sample * sample;
+
+    if (energy > 0.0)
+    {
+        const auto gain = (float) (1.0 / std::sqrt(energy));
+        for (auto& sample : impulse)
+            sample *= gain;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "PartitionedConvolver.h"
+
+// Built-in cabinet / room impulse responses for the post-voice convolution stage.
+// Held through juce::SharedResourcePointer so every plugin instance in the
+// process shares one read-only copy of each partitioned IR per sample rate.
+class CabinetImpulseLibrary
+{
+public:
+    enum Type
+    {
+        off = 0,
+        closedBack1x12,
+        openBack4x12,
+        smallRoom,
+        user,       // the impulse the user loaded from a file, owned by the processor
+        numTypes
+    };
+
+    static juce::StringArray getTypeNames();
+
+    // Longest built-in IR; used for buffer sizing and the reported tail length.
+    static constexpr double maxImpulseSeconds = 0.3;
+    static int getMaxImpulseLength(double sampleRate) noexcept;
+
+    // Not realtime safe: renders and partitions the IR on first use for a given
+    // sample rate. Returns nullptr for Type::off and Type::user. The pointer
+    // stays valid for the lifetime of the library.
+    const PartitionedImpulse* getImpulse(int type, double sampleRate);
+
+    // Not realtime safe: mixes a loaded IR down to mono, resamples it to
+    // sampleRate and truncates it to getMaxImpulseLength(), with the same fade
+    // and level matching as the built-in IRs. Returns nullptr for an empty buffer.
+    static std::unique_ptr<PartitionedImpulse> makeUserImpulse(const juce::AudioBuffer<float>& source,
+                                                               double sourceSampleRate, double sampleRate);
+
+private:
+    struct Entry
+    {
+        int type = off;
+        double sampleRate = 0.0;
+        std::unique_ptr<PartitionedImpulse> impulse;
+    };
+
+    static std::vector<float> renderImpulse(int type, double sampleRate);
+    static void fadeAndNormalise(std::vector<float>& impulse);
+
+    juce::CriticalSection lock;
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+// Fixed whole-sample delay, used to give every signal path the same latency
+// so paths can be summed or crossfaded without comb filtering.
+class CompensationDelay
+{
+public:
+    void prepare(int maximumDelayInSamples)
+    {
+        int size = 1;
+        while (size < maximumDelayInSamples + 1)
+            size <<= 1;
+
+        buffer.assign((size_t) size, 0.0f);
+        mask = size - 1;
+        delay = juce::jmin(delay, mask);
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        writeIndex = 0;
+    }
+
+    void setDelay(int newDelay) noexcept { delay = juce::jlimit(0, mask, newDelay); }
+    int getDelay() const noexcept { return delay; }
+
+    void process(float* samples, int numSamples) noexcept
+    {
+        if (delay == 0)
+            return;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer[(size_t) writeIndex] = samples[i];
+            samples[i] = buffer[(size_t) ((writeIndex - delay) & mask)];
+            writeIndex = (writeIndex + 1) & mask;
+        }
+    }
+
+private:
+    std::vector<float> buffer;
+    int mask = 0;
+    int writeIndex = 0;
+    int delay = 0;
+};
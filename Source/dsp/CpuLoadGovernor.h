@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+
+#include <juce_core/juce_core.h>
+
+// Tracks how much of each block's deadline (numSamples / sampleRate) the audio
+// callback uses and picks a quality level: 0 is best, higher levels are cheaper.
+// Steps down after load stays above stepDownLoad for stepDownSeconds, and back up
+// after it stays below stepUpLoad for stepUpSeconds. The gap between the two
+// thresholds keeps it from oscillating.
+class CpuLoadGovernor
+{
+public:
+    struct Thresholds
+    {
+        float stepDownLoad     = 0.70f; // fraction of the block deadline
+        float stepUpLoad       = 0.35f;
+        float stepDownSeconds  = 0.25f; // sustained overload before stepping down
+        float stepUpSeconds    = 2.0f;  // sustained headroom before stepping up
+        float smoothingSeconds = 0.1f;  // load averaging time constant
+    };
+
+    void prepare(double newSampleRate, int newNumLevels) noexcept
+    {
+        sampleRate = newSampleRate;
+        numLevels = juce::jmax(1, newNumLevels);
+        averageLoad.store(0.0f);
+        overloadSeconds = 0.0;
+        headroomSeconds = 0.0;
+        level.store(juce::jmin(level.load(), numLevels - 1));
+    }
+
+    // Message thread; picked up by the audio thread on its next update.
+    void setThresholds(const Thresholds& newThresholds) noexcept
+    {
+        stepDownLoad.store(newThresholds.stepDownLoad);
+        stepUpLoad.store(newThresholds.stepUpLoad);
+        stepDownSeconds.store(newThresholds.stepDownSeconds);
+        stepUpSeconds.store(newThresholds.stepUpSeconds);
+        smoothingSeconds.store(newThresholds.smoothingSeconds);
+    }
+
+    Thresholds getThresholds() const noexcept
+    {
+        return { stepDownLoad.load(), stepUpLoad.load(), stepDownSeconds.load(),
+                 stepUpSeconds.load(), smoothingSeconds.load() };
+    }
+
+    // Message thread. Disabling only requests the return to level 0; the audio
+    // thread does it on its next update, so it never races a step it is taking.
+    void setEnabled(bool shouldBeEnabled) noexcept
+    {
+        if (!shouldBeEnabled)
+            resetRequested.store(true);
+        enabled.store(shouldBeEnabled);
+    }
+
+    bool isEnabled() const noexcept    { return enabled.load(); }
+    int getLevel() const noexcept      { return level.load(); }
+    float getAverageLoad() const noexcept { return averageLoad.load(); }
+
+    // Audio thread, once per block, with the time the block took to process.
+    void update(double elapsedSeconds, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        const double blockSeconds = numSamples / sampleRate;
+        const double load = elapsedSeconds / blockSeconds;
+        const double alpha = 1.0 - std::exp(-blockSeconds / juce::jmax(0.001, (double) smoothingSeconds.load()));
+        const float average = averageLoad.load() + (float) (alpha * (load - averageLoad.load()));
+        averageLoad.store(average);
+
+        if (resetRequested.exchange(false))
+        {
+            level.store(0);
+            overloadSeconds = 0.0;
+            headroomSeconds = 0.0;
+        }
+
+        if (!enabled.load())
+            return;
+
+        int currentLevel = level.load();
+
+        overloadSeconds = average > stepDownLoad.load() ? overloadSeconds + blockSeconds : 0.0;
+        headroomSeconds = average < stepUpLoad.load() ? headroomSeconds + blockSeconds : 0.0;
+
+        if (overloadSeconds >= stepDownSeconds.load() && currentLevel < numLevels - 1)
+        {
+            ++currentLevel;
+            overloadSeconds = 0.0;
+            headroomSeconds = 0.0;
+        }
+        else if (headroomSeconds >= stepUpSeconds.load() && currentLevel > 0)
+        {
+            --currentLevel;
+            overloadSeconds = 0.0;
+            headroomSeconds = 0.0;
+        }
+
+        level.store(currentLevel);
+    }
+
+private:
+    double sampleRate = 44100.0;
+    int numLevels = 1;
+
+    std::atomic<bool> enabled { true };
+    std::atomic<bool> resetRequested { false };
+    std::atomic<int> level { 0 };
+    std::atomic<float> averageLoad { 0.0f };
+
+    // Mirrors the Thresholds defaults
+    std::atomic<float> stepDownLoad { 0.70f };
+    std::atomic<float> stepUpLoad { 0.35f };
+    std::atomic<float> stepDownSeconds { 0.25f };
+    std::atomic<float> stepUpSeconds { 2.0f };
+    std::atomic<float> smoothingSeconds { 0.1f };
+
+    // Audio thread only
+    double overloadSeconds = 0.0;
+    double headroomSeconds = 0.0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+
+// Knobs that trade DSP fidelity for CPU. Every one of them can change between
+// blocks without clicks: the delay line crossfades interpolation orders, the
+// distortion crossfades between oversampling paths padded to the same latency
+// (linear-phase filters, so no phase difference either) and the control rate
+// only changes how often the delay ramp is re-targeted.
+//
+// Oversampling adds latency, so only the offline profile uses it: realtime
+// instances stay at zero latency whatever the governor does.
+struct DspQuality
+{
+    int interpolationOrder = 3; // Lagrange order of the modulated delay read (1 = linear)
+    int oversamplingLog2   = 0; // distortion oversampling, 0 = 1x, 1 = 2x, 2 = 4x
+    int controlInterval    = 1; // samples between LFO / smoother updates (1 = audio rate)
+
+    static constexpr int maxInterpolationOrder = 5;
+    static constexpr int maxOversamplingLog2   = 2;
+};
+
+// Realtime quality ladder, best first. The CPU governor walks down it under
+// sustained load and back up once headroom returns.
+inline constexpr std::array<DspQuality, 4> kRealtimeQualityLevels {{
+    { 3, 0,  1 },
+    { 3, 0,  4 },
+    { 1, 0, 16 },
+    { 1, 0, 64 }
+}};
+
+// Offline render profile: bounces are not deadline bound, so take the best of
+// everything, latency included. Selected whenever the host reports isNonRealtime().
+inline constexpr DspQuality kRenderQuality { 5, 2, 1 };
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+// Mono delay line with a switchable Lagrange interpolation order (1 = linear).
+// A change of order crossfades from the old read to the new one over a short
+// ramp, so quality changes never click.
+class FractionalDelayLine
+{
+public:
+    static constexpr int maxOrder = 5;
+
+    void prepare(int maximumDelayInSamples)
+    {
+        int size = 1;
+        while (size < maximumDelayInSamples + maxOrder + 2)
+            size <<= 1;
+
+        buffer.assign((size_t) size, 0.0f);
+        mask = size - 1;
+        maxReadDelay = (float) (size - maxOrder - 2);
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        writeIndex = 0;
+        previousOrder = order;
+        fadeRemaining = 0;
+    }
+
+    void setOrder(int newOrder) noexcept
+    {
+        // Odd orders keep the fractional read point centred between the taps.
+        newOrder = juce::jlimit(1, maxOrder, newOrder | 1);
+        if (newOrder == order)
+            return;
+
+        previousOrder = order;
+        order = newOrder;
+        fadeRemaining = fadeLength;
+    }
+
+    int getOrder() const noexcept { return order; }
+
+    void pushSample(float sample) noexcept
+    {
+        buffer[(size_t) writeIndex] = sample;
+        writeIndex = (writeIndex + 1) & mask;
+    }
+
+    // Delay is relative to the most recently pushed sample (0 = that sample).
+    float popSample(float delayInSamples) noexcept
+    {
+        const float current = read(delayInSamples, order);
+        if (fadeRemaining <= 0)
+            return current;
+
+        const float previous = read(delayInSamples, previousOrder);
+        const float t = (float) fadeRemaining / (float) fadeLength;
+        --fadeRemaining;
+        return current + (previous - current) * t;
+    }
+
+private:
+    static constexpr int fadeLength = 256;
+
+    float tap(int delay) const noexcept
+    {
+        return buffer[(size_t) ((writeIndex - 1 - delay) & mask)];
+    }
+
+    float read(float delay, int readOrder) const noexcept
+    {
+        const float half = (float) (readOrder - 1) * 0.5f;
+        delay = juce::jlimit(half, maxReadDelay, delay);
+
+        const int base = (int) std::floor(delay - half); // first of (order + 1) taps
+        const float t = delay - (float) base;            // read position within those taps
+
+        if (readOrder == 1)
+        {
+            const float x0 = tap(base);
+            return x0 + (tap(base + 1) - x0) * t;
+        }
+
+        float result = 0.0f;
+        for (int j = 0; j <= readOrder; ++j)
+        {
+            float weight = 1.0f;
+            for (int m = 0; m <= readOrder; ++m)
+                if (m != j)
+                    weight *= (t - (float) m) / (float) (j - m);
+
+            result += weight * tap(base + j);
+        }
+
+        return result;
+    }
+
+    std::vector<float> buffer;
+    int mask = 0;
+    int writeIndex = 0;
+    float maxReadDelay = 0.0f;
+
+    int order = 3;
+    int previousOrder = 3;
+    int fadeRemaining = 0;
+};
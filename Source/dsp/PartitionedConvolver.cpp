@@ -0,0 +1,201 @@
+#include "PartitionedConvolver.h"
+
+#include <algorithm>
+
+namespace
+{
+int fftOrderFor(int blockSize)
+{
+    // Overlap-save with a block of N samples needs an FFT of 2N points.
+    int order = 0;
+    while ((1 << order) < blockSize * 2)
+        ++order;
+    return order;
+}
+
+int numPartitionsFor(int segmentLength, int blockSize)
+{
+    return segmentLength <= 0 ? 0 : (segmentLength + blockSize - 1) / blockSize;
+}
+
+// Zero-pads each blockSize chunk of the segment to 2 * blockSize and stores its
+// non-negative-frequency spectrum.
+void buildSegmentSpectra(const float* segment, int segmentLength, int blockSize,
+                         int numPartitions, std::vector<float>& spectraOut)
+{
+    const int spectrumFloats = PartitionedImpulse::spectrumSize(blockSize);
+    spectraOut.assign((size_t) (numPartitions * spectrumFloats), 0.0f);
+
+    if (numPartitions == 0)
+        return;
+
+    juce::dsp::FFT fft(fftOrderFor(blockSize));
+    std::vector<float> buffer((size_t) fft.getSize() * 2, 0.0f);
+
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        const int start = p * blockSize;
+        const int count = juce::jmin(blockSize, segmentLength - start);
+        std::copy(segment + start, segment + start + count, buffer.begin());
+
+        fft.performRealOnlyForwardTransform(buffer.data(), true);
+        std::copy(buffer.begin(), buffer.begin() + spectrumFloats,
+                  spectraOut.begin() + p * spectrumFloats);
+    }
+}
+} // namespace
+
+// ============================================================================
+PartitionedImpulse::PartitionedImpulse(const float* impulse, int numSamples)
+    : length(juce::jmax(0, numSamples))
+{
+    head.assign((size_t) headSize, 0.0f);
+    std::copy(impulse, impulse + juce::jmin(length, headSize), head.begin());
+
+    const int earlyLength = juce::jlimit(0, tailBlockSize - headSize, length - headSize);
+    numEarlyPartitions = numEarlyPartitionsFor(length);
+    buildSegmentSpectra(impulse + headSize, earlyLength, headSize, numEarlyPartitions, earlySpectra);
+
+    const int lateLength = juce::jmax(0, length - tailBlockSize);
+    numLatePartitions = numLatePartitionsFor(length);
+    buildSegmentSpectra(impulse + tailBlockSize, lateLength, tailBlockSize, numLatePartitions, lateSpectra);
+}
+
+int PartitionedImpulse::numEarlyPartitionsFor(int impulseLength) noexcept
+{
+    return numPartitionsFor(juce::jlimit(0, tailBlockSize - headSize, impulseLength - headSize), headSize);
+}
+
+int PartitionedImpulse::numLatePartitionsFor(int impulseLength) noexcept
+{
+    return numPartitionsFor(impulseLength - tailBlockSize, tailBlockSize);
+}
+
+// ============================================================================
+void PartitionedConvolver::UniformStage::prepare(int newBlockSize, int newMaxPartitions)
+{
+    blockSize = newBlockSize;
+    maxPartitions = juce::jmax(1, newMaxPartitions);
+    spectrumFloats = PartitionedImpulse::spectrumSize(blockSize);
+
+    fft = std::make_unique<juce::dsp::FFT>(fftOrderFor(blockSize));
+    const auto fftFloats = (size_t) fft->getSize() * 2;
+
+    window.assign((size_t) blockSize * 2, 0.0f);
+    fftBuffer.assign(fftFloats, 0.0f);
+    accumulator.assign(fftFloats, 0.0f);
+    inputSpectra.assign((size_t) (maxPartitions * spectrumFloats), 0.0f);
+    output.assign((size_t) blockSize, 0.0f);
+
+    reset();
+}
+
+void PartitionedConvolver::UniformStage::reset() noexcept
+{
+    std::fill(window.begin(), window.end(), 0.0f);
+    std::fill(inputSpectra.begin(), inputSpectra.end(), 0.0f);
+    std::fill(output.begin(), output.end(), 0.0f);
+    position = 0;
+    delayIndex = 0;
+}
+
+float PartitionedConvolver::UniformStage::processSample(float input, const float* spectra, int numPartitions) noexcept
+{
+    window[(size_t) (blockSize + position)] = input;
+    const float result = output[(size_t) position];
+
+    if (++position == blockSize)
+    {
+        position = 0;
+        processBlock(spectra, numPartitions);
+    }
+
+    return result;
+}
+
+void PartitionedConvolver::UniformStage::processBlock(const float* spectra, int numPartitions) noexcept
+{
+    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+    std::copy(window.begin(), window.end(), fftBuffer.begin());
+    fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+    std::copy(fftBuffer.begin(), fftBuffer.begin() + spectrumFloats,
+              inputSpectra.begin() + delayIndex * spectrumFloats);
+
+    // Frequency-domain delay line: partition p of the IR meets the input block
+    // from p blocks ago.
+    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+    const int partitions = juce::jmin(numPartitions, maxPartitions);
+
+    for (int p = 0; p < partitions; ++p)
+    {
+        const int slot = (delayIndex - p + maxPartitions) % maxPartitions;
+        const float* x = inputSpectra.data() + slot * spectrumFloats;
+        const float* h = spectra + p * spectrumFloats;
+        float* acc = accumulator.data();
+
+        for (int bin = 0; bin < spectrumFloats; bin += 2)
+        {
+            acc[bin]     += x[bin] * h[bin]     - x[bin + 1] * h[bin + 1];
+            acc[bin + 1] += x[bin] * h[bin + 1] + x[bin + 1] * h[bin];
+        }
+    }
+
+    fft->performRealOnlyInverseTransform(accumulator.data());
+
+    // Overlap-save: only the second half of the circular result is valid.
+    std::copy(accumulator.begin() + blockSize, accumulator.begin() + blockSize * 2, output.begin());
+    std::copy(window.begin() + blockSize, window.end(), window.begin());
+    delayIndex = (delayIndex + 1) % maxPartitions;
+}
+
+// ============================================================================
+void PartitionedConvolver::prepare(int maxImpulseLength)
+{
+    headHistory.assign((size_t) PartitionedImpulse::headSize * 2, 0.0f);
+    early.prepare(PartitionedImpulse::headSize, PartitionedImpulse::numEarlyPartitionsFor(maxImpulseLength));
+    late.prepare(PartitionedImpulse::tailBlockSize, PartitionedImpulse::numLatePartitionsFor(maxImpulseLength));
+    reset();
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    std::fill(headHistory.begin(), headHistory.end(), 0.0f);
+    headPosition = 0;
+    early.reset();
+    late.reset();
+}
+
+void PartitionedConvolver::setImpulse(const PartitionedImpulse* newImpulse) noexcept
+{
+    impulse = newImpulse;
+    reset();
+}
+
+float PartitionedConvolver::processSample(float input) noexcept
+{
+    if (impulse == nullptr || headHistory.empty())
+        return 0.0f;
+
+    constexpr int headSize = PartitionedImpulse::headSize;
+
+    // Newest sample sits at headPosition, so headHistory[headPosition + j] is x[n - j].
+    headPosition = (headPosition + headSize - 1) % headSize;
+    headHistory[(size_t) headPosition] = input;
+    headHistory[(size_t) (headPosition + headSize)] = input;
+
+    const float* history = headHistory.data() + headPosition;
+    const float* taps = impulse->head.data();
+    float result = 0.0f;
+    for (int j = 0; j < headSize; ++j)
+        result += taps[j] * history[j];
+
+    if (impulse->numEarlyPartitions > 0)
+        result += early.processSample(input, impulse->earlySpectra.data(), impulse->numEarlyPartitions);
+
+    if (impulse->numLatePartitions > 0)
+        result += late.processSample(input, impulse->lateSpectra.data(), impulse->numLatePartitions);
+
+    return result;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <juce_dsp/juce_dsp.h>
+
+// Impulse response split for non-uniform partitioned convolution:
+//   [0, headSize)               direct-form FIR, zero latency
+//   [headSize, tailBlockSize)   FFT partitions of headSize samples
+//   [tailBlockSize, length)     FFT partitions of tailBlockSize samples
+// Each FFT segment starts at an offset equal to its own block size, so the
+// overlap-save block delay lines up exactly behind the previous segment and
+// the convolver as a whole adds no latency.
+// Built once per IR / sample rate and then shared read-only.
+struct PartitionedImpulse
+{
+    static constexpr int headSize      = 64;
+    static constexpr int tailBlockSize = 512;
+
+    PartitionedImpulse(const float* impulse, int numSamples);
+
+    static int spectrumSize(int blockSize) noexcept { return (blockSize + 1) * 2; }
+    static int numEarlyPartitionsFor(int impulseLength) noexcept;
+    static int numLatePartitionsFor(int impulseLength) noexcept;
+
+    std::vector<float> head;
+    std::vector<float> earlySpectra; // numEarlyPartitions * spectrumSize(headSize)
+    std::vector<float> lateSpectra;  // numLatePartitions  * spectrumSize(tailBlockSize)
+    int numEarlyPartitions = 0;
+    int numLatePartitions = 0;
+    int length = 0;
+};
+
+// Mono zero-latency convolver. All allocation happens in prepare();
+// processSample() and setImpulse() are realtime safe.
+class PartitionedConvolver
+{
+public:
+    void prepare(int maxImpulseLength);
+    void reset() noexcept;
+
+    // Swaps the IR and clears the convolution history. The impulse must outlive
+    // the convolver (the shared library keeps them alive).
+    void setImpulse(const PartitionedImpulse* newImpulse) noexcept;
+
+    float processSample(float input) noexcept;
+
+private:
+    // One uniformly partitioned overlap-save segment with a frequency-domain delay line.
+    class UniformStage
+    {
+    public:
+        void prepare(int blockSize, int maxPartitions);
+        void reset() noexcept;
+        float processSample(float input, const float* spectra, int numPartitions) noexcept;
+
+    private:
+        void processBlock(const float* spectra, int numPartitions) noexcept;
+
+        std::unique_ptr<juce::dsp::FFT> fft;
+        int blockSize = 0;
+        int spectrumFloats = 0;
+        int maxPartitions = 0;
+        int position = 0;
+        int delayIndex = 0;
+
+        std::vector<float> window;       // previous block + current block (2 * blockSize)
+        std::vector<float> fftBuffer;    // 2 * fftSize, as required by juce::dsp::FFT
+        std::vector<float> accumulator;  // 2 * fftSize
+        std::vector<float> inputSpectra; // maxPartitions input spectra, ring buffer
+        std::vector<float> output;       // blockSize samples of the last computed block
+    };
+
+    const PartitionedImpulse* impulse = nullptr;
+
+    std::vector<float> headHistory; // 2 * headSize, mirrored so the FIR reads one contiguous run
+    int headPosition = 0;
+
+    UniformStage early;
+    UniformStage late;
+};
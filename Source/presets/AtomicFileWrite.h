@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+
+#include <juce_core/juce_core.h>
+
+// Replaces a file so a reader only ever sees the old contents or the new.
+//
+// The data is written to a uniquely named juce::TemporaryFile beside the
+// target, which then takes the target's place. Because the temp name is
+// unique, several instances (or threads) can write the same target at once
+// without sharing a half-written file; the last to finish wins. A failed
+// write leaves the target untouched and the temp file is removed.
+//
+// On Windows a memory-mapped target cannot be replaced: unmap it first.
+namespace AtomicFileWrite
+{
+// writeTemp fills the given (empty) file and returns false to abandon the write.
+inline bool write(const juce::File& target, const std::function<bool(const juce::File&)>& writeTemp)
+{
+    if (!target.getParentDirectory().createDirectory().wasOk())
+        return false;
+
+    juce::TemporaryFile temp(target);
+    return writeTemp(temp.getFile()) && temp.overwriteTargetFileWithTemporary();
+}
+
+inline bool write(const juce::File& target, const void* data, size_t numBytes)
+{
+    return write(target, [data, numBytes](const juce::File& file) { return file.replaceWithData(data, numBytes); });
+}
+} // namespace AtomicFileWrite
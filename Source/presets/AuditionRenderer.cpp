@@ -0,0 +1,367 @@
+#include "AuditionRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "../PluginProcessor.h"
+#include "AtomicFileWrite.h"
+#include "PresetCatalog.h"
+#include "ResourceLocator.h"
+
+namespace
+{
+// Bump when the rendering itself changes, to invalidate every cached clip
+constexpr int renderVersion = 1;
+constexpr double loopSeconds = 4.0;
+
+// Cache folders of other builds or loops are removed once nothing has used them
+// for this long; one may still belong to another instance running right now
+constexpr int staleCacheDays = 30;
+
+int getNumWorkers()
+{
+    return juce::jlimit(1, 8, juce::SystemStats::getNumCpus() - 1);
+}
+} // namespace
+
+struct AuditionRenderer::RenderSlot
+{
+    std::unique_ptr<ThreeVoicesAudioProcessor> processor;
+    int presetIndex = -1;
+    bool busy = false;
+    std::atomic<bool> finished { false };
+    std::atomic<bool> succeeded { false };
+};
+
+// Renders the loop twice through a prepared instance and keeps the second
+// pass, so delay lines, modulation and the cabinet tail wrap around the loop
+// seamlessly.
+class AuditionRenderer::RenderJob : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(AuditionRenderer& ownerIn, RenderSlot& slotIn, juce::File targetIn)
+        : juce::ThreadPoolJob("Preset audition render"),
+          owner(ownerIn), slot(slotIn), target(std::move(targetIn))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        slot.succeeded.store(render());
+        slot.finished.store(true);
+        owner.triggerAsyncUpdate();
+        return jobHasFinished;
+    }
+
+private:
+    bool render()
+    {
+        const auto& loop = owner.referenceLoop;
+        auto& processor = *slot.processor;
+
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(2, 2, clipSampleRate, renderBlockSize);
+        processor.prepareToPlay(clipSampleRate, renderBlockSize);
+
+        juce::AudioBuffer<float> clip(2, loop.getNumSamples());
+        juce::AudioBuffer<float> block(2, renderBlockSize);
+        juce::MidiBuffer midi;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (int start = 0; start < loop.getNumSamples(); start += renderBlockSize)
+            {
+                if (shouldExit())
+                {
+                    processor.releaseResources();
+                    return false;
+                }
+
+                const int numSamples = juce::jmin(renderBlockSize, loop.getNumSamples() - start);
+                block.setSize(2, numSamples, false, false, true);
+                for (int ch = 0; ch < 2; ++ch)
+                    block.copyFrom(ch, 0, loop, juce::jmin(ch, loop.getNumChannels() - 1), start, numSamples);
+
+                processor.processBlock(block, midi);
+
+                if (pass == 1)
+                    for (int ch = 0; ch < 2; ++ch)
+                        clip.copyFrom(ch, start, block, ch, 0, numSamples);
+            }
+        }
+
+        processor.releaseResources();
+        return writeClip(clip);
+    }
+
+    bool writeClip(const juce::AudioBuffer<float>& clip) const
+    {
+        return AtomicFileWrite::write(target, [&clip](const juce::File& temp)
+        {
+            auto stream = std::make_unique<juce::FileOutputStream>(temp);
+            if (!stream->openedOk())
+                return false;
+
+            juce::FlacAudioFormat flac;
+            std::unique_ptr<juce::AudioFormatWriter> writer(
+                flac.createWriterFor(stream.get(), clipSampleRate, (unsigned int) clip.getNumChannels(), 16, {}, 5));
+            if (writer == nullptr)
+                return false;
+
+            stream.release(); // now owned by the writer, which closes it before the swap
+            return writer->writeFromAudioSampleBuffer(clip, 0, clip.getNumSamples());
+        });
+    }
+
+    AuditionRenderer& owner;
+    RenderSlot& slot;
+    const juce::File target;
+};
+
+AuditionRenderer::AuditionRenderer()
+    : pool(getNumWorkers(), 0, juce::Thread::Priority::low)
+{
+}
+
+AuditionRenderer::~AuditionRenderer()
+{
+    pool.removeAllJobs(true, 10000);
+    cancelPendingUpdate();
+}
+
+juce::File AuditionRenderer::getDefaultCacheDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("3 Voice Unison Mod")
+        .getChildFile("Audition Cache");
+}
+
+void AuditionRenderer::renderMissing(const PresetCatalog& catalog)
+{
+    if (presetKeys.size() != catalog.getNumPresets())
+    {
+        presetKeys.clearQuick();
+        for (int i = 0; i < catalog.getNumPresets(); ++i)
+            presetKeys.add(catalog.getPreset(i).key);
+    }
+
+    if (referenceLoop.getNumSamples() == 0)
+    {
+        // A user-supplied loop, trimmed to loopSeconds, or the built-in one
+        juce::String loopId = "builtin";
+        if (const auto loopFile = juce::SharedResourcePointer<ResourceLocator>()->findAsset("audition_loop.wav");
+            loopFile.existsAsFile())
+        {
+            juce::WavAudioFormat wav;
+            auto stream = loopFile.createInputStream();
+            if (std::unique_ptr<juce::AudioFormatReader> reader(stream != nullptr ? wav.createReaderFor(stream.release(), true) : nullptr);
+                reader != nullptr && reader->lengthInSamples > 0)
+            {
+                const auto length = (int) juce::jmin(reader->lengthInSamples, (juce::int64) (loopSeconds * reader->sampleRate));
+                juce::AudioBuffer<float> loaded((int) juce::jlimit(1u, 2u, reader->numChannels), length);
+                reader->read(&loaded, 0, length, 0, true, true);
+                referenceLoop = resample(loaded, reader->sampleRate, clipSampleRate);
+                loopId = juce::String::toHexString((juce::int64) (loopFile.getFullPathName().hashCode64()
+                                                                  ^ loopFile.getLastModificationTime().toMilliseconds()
+                                                                  ^ loopFile.getSize()));
+            }
+        }
+
+        if (referenceLoop.getNumSamples() == 0)
+            referenceLoop = createBuiltInLoop();
+
+        const auto cacheRoot = getDefaultCacheDirectory();
+        cacheDirectory = cacheRoot.getChildFile("v" + juce::String(renderVersion) + "-"
+                                                + juce::String(JucePlugin_VersionString) + "-" + loopId);
+
+        // Touched on every start, so a folder's age is the time since any
+        // instance last used it
+        cacheDirectory.createDirectory();
+        cacheDirectory.setLastModificationTime(juce::Time::getCurrentTime());
+
+        const auto staleBefore = juce::Time::getCurrentTime() - juce::RelativeTime::days(staleCacheDays);
+        for (const auto& entry : juce::RangedDirectoryIterator(cacheRoot, false, "*", juce::File::findDirectories))
+            if (entry.getFile() != cacheDirectory && entry.getModificationTime() < staleBefore)
+                entry.getFile().deleteRecursively();
+    }
+
+    std::set<juce::String> cachedClips;
+    for (const auto& entry : juce::RangedDirectoryIterator(cacheDirectory, false, "*.flac", juce::File::findFiles))
+        cachedClips.insert(entry.getFile().getFileName());
+
+    clipReady.assign((size_t) presetKeys.size(), false);
+    for (int i = 0; i < presetKeys.size(); ++i)
+        clipReady[(size_t) i] = cachedClips.count(getClipFile(i).getFileName()) > 0;
+
+    queue.clear();
+    for (int i = 0; i < presetKeys.size(); ++i)
+    {
+        const bool inFlight = std::any_of(slots.begin(), slots.end(),
+                                          [i](const auto& slot) { return slot->busy && slot->presetIndex == i; });
+        if (!clipReady[(size_t) i] && !inFlight)
+            queue.push_back(i);
+    }
+
+    startJobs();
+}
+
+void AuditionRenderer::prioritise(int presetIndex)
+{
+    if (const auto it = std::find(queue.begin(), queue.end(), presetIndex); it != queue.end())
+    {
+        queue.erase(it);
+        queue.push_front(presetIndex);
+    }
+}
+
+bool AuditionRenderer::isClipReady(int presetIndex) const noexcept
+{
+    return juce::isPositiveAndBelow(presetIndex, (int) clipReady.size()) && clipReady[(size_t) presetIndex];
+}
+
+std::unique_ptr<juce::AudioBuffer<float>> AuditionRenderer::loadClip(int presetIndex, double sampleRate) const
+{
+    if (!isClipReady(presetIndex))
+        return nullptr;
+
+    auto stream = getClipFile(presetIndex).createInputStream();
+    if (stream == nullptr)
+        return nullptr;
+
+    juce::FlacAudioFormat flac;
+    std::unique_ptr<juce::AudioFormatReader> reader(flac.createReaderFor(stream.release(), true));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    juce::AudioBuffer<float> decoded((int) reader->numChannels, (int) reader->lengthInSamples);
+    reader->read(&decoded, 0, decoded.getNumSamples(), 0, true, true);
+
+    return std::make_unique<juce::AudioBuffer<float>>(resample(decoded, reader->sampleRate, sampleRate));
+}
+
+void AuditionRenderer::startJobs()
+{
+    if (slots.empty())
+        for (int i = 0; i < getNumWorkers(); ++i)
+            slots.push_back(std::make_unique<RenderSlot>());
+
+    for (auto& slot : slots)
+    {
+        while (!slot->busy && !queue.empty())
+        {
+            const int presetIndex = queue.front();
+            queue.pop_front();
+
+            // Configured here: the processor and its parameters belong to the message thread
+            if (slot->processor == nullptr)
+                slot->processor = std::make_unique<ThreeVoicesAudioProcessor>();
+
+            if (!slot->processor->applyImageDerivedPreset(presetIndex))
+                continue;
+
+            slot->presetIndex = presetIndex;
+            slot->busy = true;
+            slot->finished.store(false);
+            pool.addJob(new RenderJob(*this, *slot, getClipFile(presetIndex)), true);
+        }
+    }
+}
+
+void AuditionRenderer::handleAsyncUpdate()
+{
+    bool anyReady = false;
+    for (auto& slot : slots)
+    {
+        if (!slot->busy || !slot->finished.load())
+            continue;
+
+        slot->busy = false;
+        if (slot->succeeded.load() && juce::isPositiveAndBelow(slot->presetIndex, (int) clipReady.size()))
+        {
+            clipReady[(size_t) slot->presetIndex] = true;
+            anyReady = true;
+        }
+    }
+
+    startJobs();
+
+    // Nothing left to render: give back the instances
+    if (queue.empty() && std::none_of(slots.begin(), slots.end(), [](const auto& slot) { return slot->busy; }))
+        slots.clear();
+
+    if (anyReady)
+        sendChangeMessage();
+}
+
+juce::File AuditionRenderer::getClipFile(int presetIndex) const
+{
+    const auto name = juce::File::createLegalFileName(presetKeys[presetIndex].replaceCharacter('|', '-'));
+    return cacheDirectory.getChildFile(name + ".flac");
+}
+
+juce::AudioBuffer<float> AuditionRenderer::createBuiltInLoop()
+{
+    // Two bars of eighth-note Karplus-Strong plucks over Am - F - C - G at
+    // 120 bpm. Fixed seed, so every machine renders the same clips.
+    static constexpr int chords[4][4] = { { 57, 60, 64, 69 }, { 53, 57, 60, 65 }, { 48, 52, 55, 60 }, { 55, 59, 62, 67 } };
+    constexpr int notesPerChord = 4;
+    constexpr int stepsPerChord = 4;
+
+    const int length = (int) (clipSampleRate * loopSeconds);
+    const int step = length / (4 * stepsPerChord);
+    const int ringLength = step * 3;
+
+    juce::AudioBuffer<float> loop(2, length);
+    loop.clear();
+    auto* out = loop.getWritePointer(0);
+
+    juce::Random random(0x3715);
+    std::vector<float> string;
+
+    for (int chord = 0; chord < 4; ++chord)
+    {
+        for (int s = 0; s < stepsPerChord; ++s)
+        {
+            const int note = chords[chord][(s * 3) % notesPerChord];
+            const auto frequency = juce::MidiMessage::getMidiNoteInHertz(note);
+            string.resize((size_t) juce::jmax(2, (int) std::round(clipSampleRate / frequency)));
+            for (auto& sample : string)
+                sample = random.nextFloat() * 2.0f - 1.0f;
+
+            // Wraps past the end, so the last notes ring into the start of the loop
+            const int start = (chord * stepsPerChord + s) * step;
+            for (int i = 0, k = 0; i < ringLength; ++i)
+            {
+                const auto next = (size_t) (k + 1) % string.size();
+                const float sample = string[(size_t) k];
+                string[(size_t) k] = 0.996f * 0.5f * (sample + string[next]);
+                k = (int) next;
+                out[(start + i) % length] += 0.25f * sample;
+            }
+        }
+    }
+
+    loop.copyFrom(1, 0, loop, 0, 0, length);
+    return loop;
+}
+
+juce::AudioBuffer<float> AuditionRenderer::resample(const juce::AudioBuffer<float>& source, double sourceRate, double targetRate)
+{
+    if (std::abs(sourceRate - targetRate) < 1.0e-6 || sourceRate <= 0.0 || targetRate <= 0.0)
+        return source;
+
+    const auto ratio = sourceRate / targetRate;
+    const int length = juce::jmax(1, (int) std::floor(source.getNumSamples() / ratio));
+    juce::AudioBuffer<float> result(source.getNumChannels(), length);
+
+    for (int ch = 0; ch < source.getNumChannels(); ++ch)
+    {
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process(ratio, source.getReadPointer(ch), result.getWritePointer(ch), length,
+                             source.getNumSamples(), 0);
+    }
+    return result;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_events/juce_events.h>
+
+class PresetCatalog;
+class ThreeVoicesAudioProcessor;
+
+// Offline preview renderer for the factory presets.
+//
+// A reference loop (Assets/audition_loop.wav if present, otherwise a built-in
+// plucked arpeggio) is processed through each preset by private processor
+// instances on a thread pool, and the result is cached as a FLAC clip per
+// preset key. The cache folder is versioned by plugin version and loop, so a
+// new build or loop renders afresh; folders no instance has used for a month
+// are removed.
+//
+// Processor instances are created, configured and destroyed on the message
+// thread; pool threads only run prepareToPlay/processBlock and write the clip.
+// There is one instance per worker, reused across presets and released once
+// the queue drains.
+//
+// Share through juce::SharedResourcePointer<AuditionRenderer>. Message thread
+// only; a change message is sent whenever clips become ready.
+class AuditionRenderer : public juce::ChangeBroadcaster,
+                         private juce::AsyncUpdater
+{
+public:
+    static constexpr double clipSampleRate = 44100.0;
+    static constexpr int renderBlockSize = 512;
+
+    AuditionRenderer();
+    ~AuditionRenderer() override;
+
+    static juce::File getDefaultCacheDirectory();
+
+    // Queues every preset without a cached clip. Cheap when all are cached:
+    // one directory listing, no decoding.
+    void renderMissing(const PresetCatalog& catalog);
+
+    // Moves a queued preset to the front.
+    void prioritise(int presetIndex);
+
+    bool isClipReady(int presetIndex) const noexcept;
+
+    // Decodes the clip and resamples it to sampleRate; nullptr if it has not
+    // been rendered yet.
+    std::unique_ptr<juce::AudioBuffer<float>> loadClip(int presetIndex, double sampleRate) const;
+
+private:
+    struct RenderSlot;
+    class RenderJob;
+
+    void startJobs();
+    void handleAsyncUpdate() override;
+    juce::File getClipFile(int presetIndex) const;
+
+    static juce::AudioBuffer<float> createBuiltInLoop();
+    static juce::AudioBuffer<float> resample(const juce::AudioBuffer<float>& source, double sourceRate, double targetRate);
+
+    juce::File cacheDirectory; // versioned folder of the current build and loop
+    juce::StringArray presetKeys;
+    std::vector<bool> clipReady;
+    std::deque<int> queue;
+
+    juce::AudioBuffer<float> referenceLoop; // read-only while jobs run
+    juce::ThreadPool pool;
+    std::vector<std::unique_ptr<RenderSlot>> slots;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AuditionRenderer)
+};
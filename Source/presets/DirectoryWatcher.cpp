@@ -0,0 +1,176 @@
+#include "DirectoryWatcher.h"
+
+#include <map>
+#include <utility>
+
+#if JUCE_LINUX
+ #include <poll.h>
+ #include <sys/inotify.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+bool isPresetFileName(const juce::String& fileName)
+{
+    return fileName.endsWithIgnoreCase(".xml") && !fileName.startsWithChar('.');
+}
+} // namespace
+
+DirectoryWatcher::DirectoryWatcher(juce::File directoryToWatch, Callback onChange)
+    : juce::Thread("Preset directory watcher"),
+      directory(std::move(directoryToWatch)),
+      callback(std::move(onChange))
+{
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    stop();
+}
+
+void DirectoryWatcher::start()
+{
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::low);
+}
+
+void DirectoryWatcher::stop()
+{
+    signalThreadShouldExit();
+    wakeUp.signal();
+    stopThread(2000);
+}
+
+void DirectoryWatcher::requestRescan() noexcept
+{
+    rescanRequested.store(true);
+    wakeUp.signal();
+}
+
+bool DirectoryWatcher::takeRescanRequest() noexcept
+{
+    return rescanRequested.exchange(false);
+}
+
+void DirectoryWatcher::run()
+{
+#if JUCE_LINUX
+    runInotify();
+#else
+    runPolling();
+#endif
+}
+
+#if JUCE_LINUX
+void DirectoryWatcher::runInotify()
+{
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return runPolling();
+
+    constexpr auto watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF;
+    if (inotify_add_watch(fd, directory.getFullPathName().toRawUTF8(), watchMask) < 0)
+    {
+        close(fd);
+        return runPolling();
+    }
+
+    juce::Array<juce::File> changed;
+    bool fullRescan = false;
+    bool directoryLost = false;
+    alignas(inotify_event) char buffer[4096];
+
+    while (!threadShouldExit() && !directoryLost)
+    {
+        if (takeRescanRequest())
+        {
+            changed.clearQuick();
+            fullRescan = false;
+            callback({});
+        }
+
+        // Short timeout while idle so stop() and requestRescan() are noticed;
+        // once something changed, wait for debounceMs of quiet before reporting
+        pollfd pfd { fd, POLLIN, 0 };
+        const bool pending = fullRescan || !changed.isEmpty();
+        const int ready = poll(&pfd, 1, pending ? debounceMs : 100);
+
+        if (ready > 0)
+        {
+            for (;;)
+            {
+                const auto numRead = read(fd, buffer, sizeof(buffer));
+                if (numRead <= 0)
+                    break;
+
+                for (ssize_t offset = 0; offset < numRead;)
+                {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += (ssize_t) (sizeof(inotify_event) + event->len);
+
+                    if ((event->mask & IN_Q_OVERFLOW) != 0)
+                        fullRescan = true;
+                    else if ((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0)
+                        directoryLost = true;
+                    else if (event->len > 0)
+                        if (const auto name = juce::String::fromUTF8(event->name); isPresetFileName(name))
+                            changed.addIfNotAlreadyThere(directory.getChildFile(name));
+                }
+            }
+            continue;
+        }
+
+        if (ready == 0 && pending)
+        {
+            callback(fullRescan ? juce::Array<juce::File>() : changed);
+            changed.clearQuick();
+            fullRescan = false;
+        }
+    }
+
+    close(fd);
+
+    // The folder was deleted or moved away; keep watching by polling until it returns
+    if (directoryLost && !threadShouldExit())
+    {
+        rescanRequested.store(true);
+        runPolling();
+    }
+}
+#endif
+
+void DirectoryWatcher::runPolling()
+{
+    std::map<juce::String, std::pair<juce::int64, juce::int64>> known;
+
+    while (!threadShouldExit())
+    {
+        std::map<juce::String, std::pair<juce::int64, juce::int64>> current;
+        if (directory.isDirectory())
+            for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*.xml", juce::File::findFiles))
+                if (const auto name = entry.getFile().getFileName(); isPresetFileName(name))
+                    current[name] = { entry.getModificationTime().toMilliseconds(), entry.getFileSize() };
+
+        if (takeRescanRequest())
+        {
+            callback({});
+        }
+        else
+        {
+            juce::Array<juce::File> changed;
+            for (const auto& [name, stamp] : current)
+                if (const auto it = known.find(name); it == known.end() || it->second != stamp)
+                    changed.add(directory.getChildFile(name));
+            for (const auto& entry : known)
+                if (current.find(entry.first) == current.end())
+                    changed.add(directory.getChildFile(entry.first));
+
+            if (!changed.isEmpty())
+                callback(changed);
+        }
+
+        known = std::move(current);
+        wakeUp.wait(pollIntervalMs);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <juce_core/juce_core.h>
+
+// Background thread that reports changes to the *.xml files directly inside
+// one directory. On Linux it blocks on inotify, so an edit is reported within
+// the debounce time and nothing is scanned; elsewhere it compares file times
+// and sizes once per pollIntervalMs.
+//
+// The callback runs on the watcher thread with the files that were created,
+// modified or removed, or with an empty array when the whole directory must
+// be reconciled (first run, requestRescan(), or an inotify queue overflow).
+class DirectoryWatcher : private juce::Thread
+{
+public:
+    using Callback = std::function<void(const juce::Array<juce::File>& changedFiles)>;
+
+    static constexpr int debounceMs = 150;
+    static constexpr int pollIntervalMs = 1000;
+
+    DirectoryWatcher(juce::File directoryToWatch, Callback onChange);
+    ~DirectoryWatcher() override;
+
+    void start();
+    void stop();
+
+    // Asks for a full reconcile on the watcher thread.
+    void requestRescan() noexcept;
+
+private:
+    void run() override;
+    bool takeRescanRequest() noexcept;
+
+#if JUCE_LINUX
+    void runInotify();
+#endif
+    void runPolling();
+
+    const juce::File directory;
+    const Callback callback;
+    std::atomic<bool> rescanRequested { true };
+    juce::WaitableEvent wakeUp;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DirectoryWatcher)
+};
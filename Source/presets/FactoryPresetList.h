@@ -0,0 +1,73 @@
+// The factory preset list, in presetChoice order. Included with
+// THREEVOICES_PRESET(category, name) defined; no include guard on purpose.
+//
+// cmake/CompileFactoryPresets.cmake reads this file too and keys the compiled
+// preset tables by position in it, so keep to one THREEVOICES_PRESET per line
+// with plain string literals. Only ever append: the position is the
+// presetChoice value saved in sessions.
+
+THREEVOICES_PRESET("Classic Modulation", "Welcome Chorus")
+THREEVOICES_PRESET("Classic Modulation", "Mono Phase")
+THREEVOICES_PRESET("Classic Modulation", "Rotary Paradise")
+THREEVOICES_PRESET("Classic Modulation", "Color Of Love")
+THREEVOICES_PRESET("Classic Modulation", "Saturated Warble")
+THREEVOICES_PRESET("Classic Modulation", "Darko")
+THREEVOICES_PRESET("Classic Modulation", "Time Frames")
+THREEVOICES_PRESET("Classic Modulation", "Mirage")
+THREEVOICES_PRESET("Classic Modulation", "All Three Voices")
+THREEVOICES_PRESET("Classic Modulation", "Claustrophobic")
+THREEVOICES_PRESET("Guitar", "Instant Chorus")
+THREEVOICES_PRESET("Guitar", "Super Unison")
+THREEVOICES_PRESET("Guitar", "Guitar Lead I")
+THREEVOICES_PRESET("Guitar", "Guitar Lead II")
+THREEVOICES_PRESET("Guitar", "Guitar Lead III")
+THREEVOICES_PRESET("Guitar", "Purple Mk.Prince")
+THREEVOICES_PRESET("Guitar", "Acoustic Nylon")
+THREEVOICES_PRESET("Guitar", "Black Hole Garden")
+THREEVOICES_PRESET("Guitar", "Tape Warble")
+THREEVOICES_PRESET("Guitar", "Seasick")
+THREEVOICES_PRESET("Keys / Synth", "That's Better")
+THREEVOICES_PRESET("Keys / Synth", "Speed + Movement")
+THREEVOICES_PRESET("Keys / Synth", "Nostalgic Aqua Lead")
+THREEVOICES_PRESET("Keys / Synth", "Laura Palmer")
+THREEVOICES_PRESET("Keys / Synth", "Wavy Pluck")
+THREEVOICES_PRESET("Keys / Synth", "More Space")
+THREEVOICES_PRESET("Keys / Synth", "Mono Rhodes")
+THREEVOICES_PRESET("Keys / Synth", "Terminator II")
+THREEVOICES_PRESET("Keys / Synth", "Distorted Lead")
+THREEVOICES_PRESET("Keys / Synth", "Demarco Days")
+THREEVOICES_PRESET("Bass", "Underwater")
+THREEVOICES_PRESET("Bass", "Analog Movement")
+THREEVOICES_PRESET("Bass", "1960's Slap Delay")
+THREEVOICES_PRESET("Bass", "White Stripes Bass Player")
+THREEVOICES_PRESET("Bass", "Moog Wide")
+THREEVOICES_PRESET("Bass", "Just Like The Cure")
+THREEVOICES_PRESET("Bass", "Silverlake")
+THREEVOICES_PRESET("Bass", "Plucky Synth Bass")
+THREEVOICES_PRESET("Bass", "As You Are")
+THREEVOICES_PRESET("Bass", "Slammed")
+THREEVOICES_PRESET("Drums", "Wide Kit")
+THREEVOICES_PRESET("Drums", "Mono Break")
+THREEVOICES_PRESET("Drums", "Trash Loop")
+THREEVOICES_PRESET("Drums", "Crush Room")
+THREEVOICES_PRESET("Drums", "Phase Bus")
+THREEVOICES_PRESET("Drums", "Dirty OH")
+THREEVOICES_PRESET("Drums", "Vintage Groove")
+THREEVOICES_PRESET("Drums", "Cymbal Swirl")
+THREEVOICES_PRESET("Drums", "Tape Drift")
+THREEVOICES_PRESET("Drums", "Snap Room")
+THREEVOICES_PRESET("Vocals", "Vocal Double")
+THREEVOICES_PRESET("Vocals", "Unison Belt")
+THREEVOICES_PRESET("Vocals", "Yachty In Poland")
+THREEVOICES_PRESET("Vocals", "Classic Slapback")
+THREEVOICES_PRESET("Vocals", "Hypnosis")
+THREEVOICES_PRESET("Vocals", "Subtle BG's")
+THREEVOICES_PRESET("Vocals", "Massive Vox")
+THREEVOICES_PRESET("Vocals", "Hurdy Gurdy")
+THREEVOICES_PRESET("Vocals", "Psychedelic Anthem")
+THREEVOICES_PRESET("Vocals", "Distorted Crimson")
+THREEVOICES_PRESET("Basics", "Classic Chorus")
+THREEVOICES_PRESET("Basics", "Lo-Fi Chorus")
+THREEVOICES_PRESET("Basics", "Subtle Vibrato")
+THREEVOICES_PRESET("Basics", "Warm Tube Unison")
+THREEVOICES_PRESET("Basics", "Wide Unison")
@@ -0,0 +1,150 @@
+#include "PresetCatalog.h"
+#include "ResourceLocator.h"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+bool isPreviewImage(const juce::File& file)
+{
+    const auto extension = file.getFileExtension().toLowerCase();
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+}
+} // namespace
+
+juce::String PresetCatalog::sanitiseDisplayName(juce::String name)
+{
+    name = name.trim();
+    while (name.contains("  "))
+        name = name.replace("  ", " ");
+    name = name.replace("_", " ");
+    name = name.replace(".png", "", true);
+    name = name.replace(".jpg", "", true);
+    name = name.replace(".jpeg", "", true);
+    return name.trim();
+}
+
+juce::String PresetCatalog::stripOrderingPrefix(juce::String name)
+{
+    name = sanitiseDisplayName(name);
+
+    int index = 0;
+    while (index < name.length() && juce::CharacterFunctions::isDigit(name[index]))
+        ++index;
+
+    if (index > 0)
+    {
+        while (index < name.length() && (name[index] == ' ' || name[index] == '-' || name[index] == '_'))
+            ++index;
+        name = name.substring(index).trim();
+    }
+
+    return sanitiseDisplayName(name);
+}
+
+juce::String PresetCatalog::normaliseCategoryName(juce::String folderName)
+{
+    folderName = sanitiseDisplayName(folderName);
+    if (folderName.equalsIgnoreCase("Keys Synth")
+        || folderName.equalsIgnoreCase("Keys / Synth")
+        || folderName.equalsIgnoreCase("Keys _ Synth"))
+        return "Keys / Synth";
+    return folderName;
+}
+
+juce::String PresetCatalog::makeKey(const juce::String& category, const juce::String& preset)
+{
+    auto key = (normaliseCategoryName(category) + "|" + sanitiseDisplayName(preset)).toLowerCase();
+    key = key.removeCharacters(" .,_'!-+()/\\");
+    return key;
+}
+
+PresetCatalog PresetCatalog::build()
+{
+    PresetCatalog catalog;
+
+#define THREEVOICES_PRESET(category, name) catalog.add(category, name);
+#include "FactoryPresetList.h"
+#undef THREEVOICES_PRESET
+
+    catalog.buildSearchIndex();
+    return catalog;
+}
+
+void PresetCatalog::add(const juce::String& category, const juce::String& name)
+{
+    // Presets arrive grouped by category, so a new name always starts a new category
+    if (categories.empty() || categories.back().name != category)
+        categories.push_back({ category, (int) presets.size(), 0 });
+
+    Preset preset;
+    preset.name = name;
+    preset.displayName = category + " - " + name;
+    preset.key = makeKey(category, name);
+    preset.category = (int) categories.size() - 1;
+    preset.indexInCategory = categories.back().numPresets++;
+
+    displayNames.add(preset.displayName);
+    presets.push_back(std::move(preset));
+}
+
+void PresetCatalog::buildSearchIndex()
+{
+    // Names first so they read naturally; the category makes "bass" or "vocals" find a whole group
+    juce::StringArray documents;
+    for (const auto& preset : presets)
+        documents.add(preset.name + " " + categories[(size_t) preset.category].name);
+
+    searchIndex.build(documents);
+}
+
+const PresetCatalog::Preset& PresetCatalog::getPreset(int index) const noexcept
+{
+    jassert(!presets.empty());
+    return presets[(size_t) juce::jlimit(0, getNumPresets() - 1, index)];
+}
+
+const PresetCatalog::Category& PresetCatalog::getCategory(int index) const noexcept
+{
+    jassert(!categories.empty());
+    return categories[(size_t) juce::jlimit(0, getNumCategories() - 1, index)];
+}
+
+int PresetCatalog::getPresetIndex(int category, int indexInCategory) const noexcept
+{
+    if (category < 0 || category >= getNumCategories())
+        return -1;
+
+    const auto& entry = categories[(size_t) category];
+    if (indexInCategory < 0 || indexInCategory >= entry.numPresets)
+        return -1;
+
+    return entry.firstPreset + indexInCategory;
+}
+
+std::vector<juce::File> PresetCatalog::findPreviewImages() const
+{
+    std::vector<juce::File> images((size_t) getNumPresets());
+
+    const auto presetRoot = juce::SharedResourcePointer<ResourceLocator>()->getPresetImageRoot();
+    if (!presetRoot.isDirectory())
+        return images;
+
+    // Image files are matched to presets by key, so folder order and
+    // "01 " style numbering prefixes do not matter
+    std::map<juce::String, juce::File> imagesByKey;
+    for (const auto& categoryEntry : juce::RangedDirectoryIterator(presetRoot, false, "*", juce::File::findDirectories))
+    {
+        const auto category = categoryEntry.getFile().getFileName();
+        for (const auto& entry : juce::RangedDirectoryIterator(categoryEntry.getFile(), false, "*", juce::File::findFiles))
+            if (isPreviewImage(entry.getFile()))
+                imagesByKey.emplace(makeKey(category, stripOrderingPrefix(entry.getFile().getFileNameWithoutExtension())), entry.getFile());
+    }
+
+    for (size_t i = 0; i < presets.size(); ++i)
+        if (const auto found = imagesByKey.find(presets[i].key); found != imagesByKey.end())
+            images[i] = found->second;
+
+    return images;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "PresetSearchIndex.h"
+
+// The factory preset list, built once from the embedded manifest and then
+// immutable. Presets are addressed by their flat index (the "presetChoice"
+// parameter value) or by (category, position in category); both lookups are
+// O(1). Names, display
+// strings and preset keys are computed at build time, so nothing downstream
+// parses "Category - Preset" strings.
+//
+// The processor owns the catalog; the editor and the preset overlay take it
+// by const reference.
+class PresetCatalog
+{
+public:
+    struct Preset
+    {
+        juce::String name;        // "Mono Phase"
+        juce::String displayName; // "Classic Modulation - Mono Phase", also the parameter choice text
+        juce::String key;         // makeKey(category, name): ImageDerived.xml / compiled preset key
+        int category = 0;
+        int indexInCategory = 0;
+    };
+
+    struct Category
+    {
+        juce::String name;
+        int firstPreset = 0;
+        int numPresets = 0;
+    };
+
+    // The built-in preset list. No filesystem access, so it is safe in the
+    // processor constructor and the parameter's choices never depend on disk.
+    static PresetCatalog build();
+
+    int getNumPresets() const noexcept    { return (int) presets.size(); }
+    int getNumCategories() const noexcept { return (int) categories.size(); }
+    bool isEmpty() const noexcept         { return presets.empty(); }
+
+    // Out-of-range indices are clamped; only call on a non-empty catalog.
+    const Preset& getPreset(int index) const noexcept;
+    const Category& getCategory(int index) const noexcept;
+
+    // Flat index of a preset within a category, or -1.
+    int getPresetIndex(int category, int indexInCategory) const noexcept;
+
+    // Every displayName in order, for the presetChoice parameter.
+    const juce::StringArray& getDisplayNames() const noexcept { return displayNames; }
+
+    // Search over preset and category names; results are flat preset indices.
+    const PresetSearchIndex& getSearchIndex() const noexcept { return searchIndex; }
+
+    // Preview image per preset from the "Unison Mod PRESETS" folder, empty
+    // where there is none. Scans the disk: for the editor, not the processor.
+    std::vector<juce::File> findPreviewImages() const;
+
+    // Naming rules shared by the folder scan and the preset keys
+    static juce::String sanitiseDisplayName(juce::String name);
+    static juce::String stripOrderingPrefix(juce::String name);
+    static juce::String normaliseCategoryName(juce::String folderName);
+    static juce::String makeKey(const juce::String& category, const juce::String& preset);
+
+private:
+    void add(const juce::String& category, const juce::String& name);
+    void buildSearchIndex();
+
+    std::vector<Preset> presets;
+    std::vector<Category> categories;
+    juce::StringArray displayNames;
+    PresetSearchIndex searchIndex;
+};
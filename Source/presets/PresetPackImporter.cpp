@@ -0,0 +1,252 @@
+#include "PresetPackImporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <set>
+
+#include "AtomicFileWrite.h"
+#include "PresetCatalog.h"
+
+namespace PresetPackImporter
+{
+namespace
+{
+struct FileResult
+{
+    std::vector<UserPresetIndex::Record> records;
+    juce::StringArray messages;
+    int numSkipped = 0;
+};
+
+int resolveId(const juce::String& id)
+{
+    if (const auto index = ParamIds::find(id.toRawUTF8()); index >= 0)
+        return index;
+
+    for (int i = 0; i < ParamIds::numParams; ++i)
+        if (id.equalsIgnoreCase(ParamIds::ids[(size_t) i]))
+            return i;
+
+    return -1;
+}
+
+// Legacy duplicates map onto the per-voice parameter they mirror
+int canonicalIndex(int index) noexcept
+{
+    for (int v = 0; v < 3; ++v)
+    {
+        if (index == ParamIds::legacyVoiceOn(v))   return ParamIds::forVoice(v, ParamIds::voiceOn);
+        if (index == ParamIds::legacyVoiceTube(v)) return ParamIds::forVoice(v, ParamIds::voiceTube);
+        if (index == ParamIds::legacyVoiceBit(v))  return ParamIds::forVoice(v, ParamIds::voiceBit);
+    }
+    return index;
+}
+
+bool isSwitch(int index) noexcept
+{
+    for (int v = 0; v < 3; ++v)
+        if (index == ParamIds::forVoice(v, ParamIds::voiceOn) || index == ParamIds::forVoice(v, ParamIds::voiceTube)
+            || index == ParamIds::forVoice(v, ParamIds::voiceBit))
+            return true;
+    return false;
+}
+
+bool readPreset(const juce::XmlElement& xml, const ParameterRanges& ranges,
+                UserPresetIndex::Record& record, juce::StringArray& messages)
+{
+    record.mask = 0;
+
+    forEachXmlChildElementWithTagName(xml, paramXml, "PARAM")
+    {
+        const auto id = paramXml->getStringAttribute("id");
+        const auto index = canonicalIndex(resolveId(id));
+        if (index < 0)
+        {
+            messages.add(record.fileName + ": unknown parameter \"" + id + "\" ignored");
+            continue;
+        }
+
+        if (index == ParamIds::presetChoice || index == ParamIds::morph)
+            continue;
+
+        const auto value = (float) paramXml->getDoubleAttribute("value", std::numeric_limits<double>::quiet_NaN());
+        if (!std::isfinite(value))
+        {
+            messages.add(record.fileName + ": \"" + id + "\" has no numeric value");
+            continue;
+        }
+
+        auto& stored = record.values[(size_t) index];
+        const auto bit = juce::uint64 { 1 } << index;
+        const auto clamped = ranges[(size_t) index].snapToLegalValue(value);
+
+        // A switch set by either the current or the legacy ID stays on, as at runtime
+        stored = (record.mask & bit) != 0 && isSwitch(index) ? juce::jmax(stored, clamped) : clamped;
+        record.mask |= bit;
+    }
+
+    return record.mask != 0;
+}
+
+FileResult parseFile(const juce::File& file, const juce::File& packDirectory, const ParameterRanges& ranges)
+{
+    FileResult result;
+    const auto relativePath = file.getRelativePathFrom(packDirectory).replaceCharacter('\\', '/');
+
+    const auto document = juce::XmlDocument::parse(file);
+    if (document == nullptr)
+    {
+        result.messages.add(relativePath + ": not valid XML");
+        ++result.numSkipped;
+        return result;
+    }
+
+    const auto folder = file.getParentDirectory();
+    const auto defaultCategory = PresetCatalog::sanitiseDisplayName(folder == packDirectory ? packDirectory.getFileName()
+                                                                                            : folder.getFileName());
+
+    auto makeRecord = [&](const juce::XmlElement& xml, const juce::String& fallbackName)
+    {
+        UserPresetIndex::Record record;
+        record.fileName = relativePath;
+        record.name = xml.getStringAttribute("name", fallbackName).trim();
+        record.category = xml.getStringAttribute("category", defaultCategory).trim();
+        record.tags = xml.getStringAttribute("tags").trim();
+        record.modificationTime = file.getLastModificationTime().toMilliseconds();
+        record.fileSize = file.getSize();
+
+        if (record.name.isEmpty())
+            result.messages.add(relativePath + ": preset without a name skipped");
+        else if (!readPreset(xml, ranges, record, result.messages))
+            result.messages.add(relativePath + ": \"" + record.name + "\" sets no known parameters");
+        else
+        {
+            result.records.push_back(std::move(record));
+            return;
+        }
+        ++result.numSkipped;
+    };
+
+    if (document->hasTagName("Parameters"))
+    {
+        makeRecord(*document, PresetCatalog::stripOrderingPrefix(file.getFileNameWithoutExtension()));
+        return result;
+    }
+
+    forEachXmlChildElementWithTagName(*document, presetXml, "PRESET")
+        makeRecord(*presetXml, presetXml->getStringAttribute("key"));
+
+    if (result.records.empty() && result.numSkipped == 0)
+    {
+        result.messages.add(relativePath + ": no presets found");
+        ++result.numSkipped;
+    }
+
+    return result;
+}
+
+class ParseJob : public juce::ThreadPoolJob
+{
+public:
+    ParseJob(const juce::Array<juce::File>& filesIn, std::vector<FileResult>& resultsIn, std::atomic<int>& nextIn,
+             const juce::File& packDirectoryIn, const ParameterRanges& rangesIn)
+        : juce::ThreadPoolJob("Preset pack import"),
+          files(filesIn), results(resultsIn), next(nextIn), packDirectory(packDirectoryIn), ranges(rangesIn)
+    {
+    }
+
+    // Each job takes the next unparsed file until none are left, so slow
+    // files do not hold up a fixed share of the pack
+    JobStatus runJob() override
+    {
+        for (int i = next.fetch_add(1); i < files.size() && !shouldExit(); i = next.fetch_add(1))
+            results[(size_t) i] = parseFile(files.getReference(i), packDirectory, ranges);
+
+        return jobHasFinished;
+    }
+
+private:
+    const juce::Array<juce::File>& files;
+    std::vector<FileResult>& results;
+    std::atomic<int>& next;
+    const juce::File& packDirectory;
+    const ParameterRanges& ranges;
+};
+} // namespace
+
+Result importPack(const juce::File& packDirectory, const juce::File& bundleFile,
+                  const ParameterRanges& ranges, int numThreads)
+{
+    Result result;
+    if (!packDirectory.isDirectory())
+    {
+        result.messages.add(packDirectory.getFullPathName() + ": not a folder");
+        return result;
+    }
+
+    juce::Array<juce::File> files;
+    for (const auto& entry : juce::RangedDirectoryIterator(packDirectory, true, "*.xml", juce::File::findFiles))
+        files.add(entry.getFile());
+    files.sort();
+    result.numFiles = files.size();
+
+    std::vector<FileResult> fileResults((size_t) files.size());
+    {
+        const int threads = juce::jlimit(1, juce::jmax(1, files.size()),
+                                         numThreads > 0 ? numThreads : juce::SystemStats::getNumCpus());
+        juce::ThreadPool pool(threads);
+        std::atomic<int> next { 0 };
+
+        std::vector<std::unique_ptr<ParseJob>> jobs;
+        for (int i = 0; i < threads; ++i)
+        {
+            jobs.push_back(std::make_unique<ParseJob>(files, fileResults, next, packDirectory, ranges));
+            pool.addJob(jobs.back().get(), false);
+        }
+
+        for (auto& job : jobs)
+            pool.waitForJobToFinish(job.get(), -1);
+    }
+
+    // Merged in file order; the first preset of a given category and name wins
+    std::vector<UserPresetIndex::Record> records;
+    std::set<juce::String> seen;
+    for (auto& fileResult : fileResults)
+    {
+        result.messages.addArray(fileResult.messages);
+        result.numSkipped += fileResult.numSkipped;
+
+        for (auto& record : fileResult.records)
+        {
+            if (!seen.insert(record.category.toLowerCase() + "|" + record.name.toLowerCase()).second)
+            {
+                result.messages.add(record.fileName + ": duplicate of \"" + record.category + " - " + record.name + "\" skipped");
+                ++result.numSkipped;
+                continue;
+            }
+            records.push_back(std::move(record));
+        }
+    }
+
+    std::sort(records.begin(), records.end(), [](const UserPresetIndex::Record& a, const UserPresetIndex::Record& b)
+    {
+        if (const auto order = a.category.compareNatural(b.category); order != 0)
+            return order < 0;
+        return a.name.compareNatural(b.name) < 0;
+    });
+
+    result.numImported = (int) records.size();
+
+    juce::MemoryBlock image;
+    UserPresetIndex::write(records, image);
+
+    result.bundleWritten = AtomicFileWrite::write(bundleFile, image.getData(), image.getSize());
+    if (!result.bundleWritten)
+        result.messages.add(bundleFile.getFullPathName() + ": could not be written");
+
+    return result;
+}
+} // namespace PresetPackImporter
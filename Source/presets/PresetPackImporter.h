@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+
+#include <juce_core/juce_core.h>
+
+#include "UserPresetIndex.h"
+
+// Turns a third-party preset pack folder into one preset bundle.
+//
+// Every *.xml below the pack folder is read: single presets
+// (<Parameters name category tags> with PARAM children, the user preset
+// format) and multi-preset files (any root holding <PRESET name category key>
+// elements, like ImageDerived.xml). Files are parsed and validated in
+// parallel on a thread pool, one result slot per file, then merged in file
+// order so the output does not depend on thread timing.
+//
+// Per preset:
+//   - legacy duplicate IDs (voiceN, dist_tube_N, dist_bit_N) are folded into
+//     the per-voice switches and not stored themselves
+//   - IDs are matched exactly, then case-insensitively; unknown IDs are
+//     reported and ignored
+//   - values are clamped and snapped to the parameter ranges; non-finite
+//     values are dropped
+//   - presetChoice and morph are session state and are never stored
+//   - the category falls back to the sub-folder, the name to the file name
+//     without "01 " style ordering prefixes
+//
+// The bundle uses the UserPresetIndex format, so it is read through a
+// memory-mapped UserPresetIndex::View with no parsing at load time.
+namespace PresetPackImporter
+{
+using ParameterRanges = std::array<juce::NormalisableRange<float>, ParamIds::numParams>;
+
+constexpr const char* bundleExtension = ".3vpack";
+
+struct Result
+{
+    int numFiles = 0;
+    int numImported = 0;
+    int numSkipped = 0;     // invalid, empty or duplicate presets
+    juce::StringArray messages; // one line per skipped preset or ignored ID
+    bool bundleWritten = false;
+};
+
+// Blocks until done; numThreads <= 0 uses one thread per core.
+Result importPack(const juce::File& packDirectory, const juce::File& bundleFile,
+                  const ParameterRanges& ranges, int numThreads = 0);
+} // namespace PresetPackImporter
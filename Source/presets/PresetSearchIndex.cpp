@@ -0,0 +1,207 @@
+#include "PresetSearchIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+int PresetSearchIndex::symbolOf(char c) noexcept
+{
+    if (c >= 'a' && c <= 'z') return 1 + (c - 'a');
+    if (c >= '0' && c <= '9') return 27 + (c - '0');
+    return 0;
+}
+
+int PresetSearchIndex::trigramOf(const char* chars) noexcept
+{
+    return (symbolOf(chars[0]) * alphabetSize + symbolOf(chars[1])) * alphabetSize + symbolOf(chars[2]);
+}
+
+std::string PresetSearchIndex::fold(const juce::String& text)
+{
+    // Everything that is not an ASCII letter or digit separates words
+    std::string folded(1, ' ');
+    for (auto p = text.getCharPointer(); !p.isEmpty(); ++p)
+    {
+        const auto c = juce::CharacterFunctions::toLowerCase(*p);
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))
+            folded.push_back((char) c);
+        else if (folded.back() != ' ')
+            folded.push_back(' ');
+    }
+
+    if (folded.back() != ' ')
+        folded.push_back(' ');
+    return folded;
+}
+
+void PresetSearchIndex::build(const juce::StringArray& documents)
+{
+    texts.clear();
+    texts.reserve((size_t) documents.size());
+    for (const auto& document : documents)
+        texts.push_back(fold(document));
+
+    // Posting lists in one flat array (CSR): count, prefix-sum, fill
+    std::vector<std::pair<int, int>> occurrences; // (trigram, document)
+    for (int doc = 0; doc < (int) texts.size(); ++doc)
+    {
+        const auto& text = texts[(size_t) doc];
+        const auto firstForDoc = occurrences.size();
+        for (size_t i = 0; i + 2 < text.size(); ++i)
+            occurrences.emplace_back(trigramOf(text.data() + i), doc);
+
+        // One entry per (trigram, document)
+        std::sort(occurrences.begin() + (std::ptrdiff_t) firstForDoc, occurrences.end());
+        occurrences.erase(std::unique(occurrences.begin() + (std::ptrdiff_t) firstForDoc, occurrences.end()),
+                          occurrences.end());
+    }
+
+    postingStarts.assign((size_t) numTrigrams + 1, 0);
+    for (const auto& occurrence : occurrences)
+        ++postingStarts[(size_t) occurrence.first + 1];
+    for (size_t i = 1; i < postingStarts.size(); ++i)
+        postingStarts[i] += postingStarts[i - 1];
+
+    // Documents were visited in order, so every list comes out sorted
+    postingIds.resize(occurrences.size());
+    auto fill = postingStarts;
+    for (const auto& occurrence : occurrences)
+        postingIds[(size_t) fill[(size_t) occurrence.first]++] = occurrence.second;
+
+    for (auto& list : initialPostings)
+        list.clear();
+
+    for (int doc = 0; doc < (int) texts.size(); ++doc)
+    {
+        const auto& text = texts[(size_t) doc];
+        for (size_t i = 0; i + 1 < text.size(); ++i)
+        {
+            if (text[i] != ' ' || text[i + 1] == ' ')
+                continue;
+
+            auto& list = initialPostings[(size_t) symbolOf(text[i + 1])];
+            if (list.empty() || list.back() != doc)
+                list.push_back(doc);
+        }
+    }
+}
+
+std::vector<int> PresetSearchIndex::candidatesFor(const std::string& word) const
+{
+    if (word.size() == 1)
+        return initialPostings[(size_t) symbolOf(word[0])];
+
+    // Two letters can only be matched as a word prefix; longer words match anywhere
+    const auto grams = word.size() == 2 ? " " + word : word;
+
+    std::vector<std::pair<const int*, const int*>> lists;
+    for (size_t i = 0; i + 2 < grams.size(); ++i)
+    {
+        const auto code = (size_t) trigramOf(grams.data() + i);
+        const auto* begin = postingIds.data() + postingStarts[code];
+        const auto* end = postingIds.data() + postingStarts[code + 1];
+        if (begin == end)
+            return {};
+        lists.emplace_back(begin, end);
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b)
+    {
+        return a.second - a.first < b.second - b.first;
+    });
+
+    std::vector<int> result(lists.front().first, lists.front().second);
+    std::vector<int> scratch;
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i)
+    {
+        scratch.clear();
+        std::set_intersection(result.begin(), result.end(), lists[i].first, lists[i].second,
+                              std::back_inserter(scratch));
+        std::swap(result, scratch);
+    }
+    return result;
+}
+
+std::vector<int> PresetSearchIndex::search(const juce::String& query, int maxResults) const
+{
+    std::vector<std::string> words;
+    {
+        const auto folded = fold(query);
+        size_t start = 1;
+        for (size_t i = 1; i < folded.size(); ++i)
+        {
+            if (folded[i] != ' ')
+                continue;
+            if (i > start)
+                words.push_back(folded.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+
+    if (words.empty() || texts.empty())
+        return {};
+
+    // Start from the rarest word's candidates
+    size_t fewest = 0;
+    std::vector<std::vector<int>> perWord;
+    perWord.reserve(words.size());
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+        perWord.push_back(candidatesFor(words[w]));
+        if (perWord.back().empty())
+            return {};
+        if (perWord.back().size() < perWord[fewest].size())
+            fewest = w;
+    }
+    const auto candidates = std::move(perWord[fewest]);
+
+    // Trigrams can match across positions, so confirm each candidate and score it:
+    // 0 per word found at a word start, 1 per word found inside a word
+    std::vector<std::pair<int, int>> scored; // (score, document)
+    for (const auto doc : candidates)
+    {
+        const auto& text = texts[(size_t) doc];
+        int score = 0;
+        bool matched = true;
+
+        for (const auto& word : words)
+        {
+            // Words under three letters only match as a word prefix, as in candidatesFor
+            // (the folded text starts with a space, so this covers its first word too)
+            if (word.size() < 3)
+            {
+                if (text.find(" " + word) == std::string::npos)
+                {
+                    matched = false;
+                    break;
+                }
+                continue;
+            }
+
+            const auto at = text.find(word);
+            if (at == std::string::npos)
+            {
+                matched = false;
+                break;
+            }
+
+            if (text[at - 1] != ' ' && text.find(" " + word) == std::string::npos)
+                ++score;
+        }
+
+        if (matched)
+            scored.emplace_back(score, doc);
+    }
+
+    std::stable_sort(scored.begin(), scored.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<int> results;
+    results.reserve(juce::jmin(scored.size(), (size_t) juce::jmax(0, maxResults)));
+    for (const auto& entry : scored)
+    {
+        if ((int) results.size() >= maxResults)
+            break;
+        results.push_back(entry.second);
+    }
+    return results;
+}
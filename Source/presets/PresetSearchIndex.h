@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+// As-you-type search over preset names and tags.
+//
+// Text is folded to lower-case letters, digits and single spaces, and every
+// trigram of " text " gets a posting list of document ids. A query word is
+// answered by intersecting the posting lists of its trigrams (smallest first)
+// and verifying only the surviving candidates, so a keystroke never walks the
+// whole library. One-letter words use a separate word-initial list.
+//
+// Results rank word-prefix matches ahead of matches inside a word, then keep
+// document order. Built once; queries are const and allocation-light.
+class PresetSearchIndex
+{
+public:
+    void build(const juce::StringArray& documents);
+
+    // Ids of documents matching every word of the query, best first.
+    // An empty query matches nothing.
+    std::vector<int> search(const juce::String& query, int maxResults = 200) const;
+
+    int getNumDocuments() const noexcept { return (int) texts.size(); }
+
+private:
+    static constexpr int alphabetSize = 37; // space, a-z, 0-9
+    static constexpr int numTrigrams = alphabetSize * alphabetSize * alphabetSize;
+
+    static std::string fold(const juce::String& text);
+    static int symbolOf(char c) noexcept;
+    static int trigramOf(const char* chars) noexcept;
+
+    std::vector<int> candidatesFor(const std::string& word) const;
+
+    std::vector<std::string> texts; // folded " text " per document
+    std::vector<int> postingStarts; // numTrigrams + 1 offsets into postingIds
+    std::vector<int> postingIds;
+    std::array<std::vector<int>, alphabetSize> initialPostings;
+};
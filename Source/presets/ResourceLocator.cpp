@@ -0,0 +1,116 @@
+#include "ResourceLocator.h"
+
+namespace
+{
+constexpr int maxParentLevels = 6;
+}
+
+ResourceLocator::~ResourceLocator()
+{
+    // The watcher callback never takes the lock, so stopping under it cannot deadlock
+    const juce::ScopedLock sl(lock);
+    if (watcher != nullptr)
+        watcher->stop();
+}
+
+juce::File ResourceLocator::getPresetImageRoot()
+{
+    const auto root = resolve({ "Unison Mod PRESETS" });
+    return root.isDirectory() ? root : juce::File();
+}
+
+juce::File ResourceLocator::getImageDerivedPresetFile()
+{
+    const auto file = resolve({ "Presets/ImageDerived.xml" });
+    if (file.existsAsFile())
+        watchDirectory(file.getParentDirectory());
+    return file;
+}
+
+juce::File ResourceLocator::getFactoryPresetFile(const juce::String& presetName)
+{
+    return resolve({ "Presets/" + presetName + ".xml" });
+}
+
+juce::File ResourceLocator::findAsset(const juce::String& fileName)
+{
+    return resolve({ fileName, "assets/" + fileName, "Assets/" + fileName });
+}
+
+juce::File ResourceLocator::resolve(const juce::StringArray& relativePaths)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (stale.exchange(false))
+    {
+        resolved.clear();
+        buildSearchDirectories();
+    }
+
+    const auto key = relativePaths.joinIntoString("\n");
+    if (const auto found = resolved.find(key); found != resolved.end())
+        return found->second;
+
+    juce::File result;
+    for (const auto& directory : searchDirectories)
+    {
+        for (const auto& relativePath : relativePaths)
+        {
+            if (const auto candidate = directory.getChildFile(relativePath); candidate.exists())
+            {
+                result = candidate;
+                break;
+            }
+        }
+        if (result != juce::File())
+            break;
+    }
+
+    resolved[key] = result;
+    return result;
+}
+
+void ResourceLocator::buildSearchDirectories()
+{
+    searchDirectories.clearQuick();
+
+    const juce::File roots[] {
+        juce::File::getCurrentWorkingDirectory(),
+        juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory(),
+        juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory()
+    };
+
+    // The roots usually share most of their parents; each directory is listed once
+    for (const auto& root : roots)
+    {
+        auto dir = root;
+        for (int d = 0; d < maxParentLevels; ++d)
+        {
+            searchDirectories.addIfNotAlreadyThere(dir);
+            if (dir.isRoot())
+                break;
+            dir = dir.getParentDirectory();
+        }
+    }
+}
+
+void ResourceLocator::watchDirectory(const juce::File& directory)
+{
+    const juce::ScopedLock sl(lock);
+    if (directory == watchedDirectory)
+        return;
+
+    if (watcher != nullptr)
+        watcher->stop();
+
+    watchedDirectory = directory;
+    watcherPrimed.store(false);
+
+    // The first callback is the watcher's initial scan, not a change
+    watcher = std::make_unique<DirectoryWatcher>(directory, [this](const juce::Array<juce::File>&)
+    {
+        if (watcherPrimed.exchange(true))
+            invalidate();
+    });
+    watcher->start();
+}
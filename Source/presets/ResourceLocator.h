@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+#include <juce_core/juce_core.h>
+
+#include "DirectoryWatcher.h"
+
+// Finds the plugin's loose files: the preset image folder, the ImageDerived
+// preset XML, single-file factory presets and editor assets. Each is searched for next to the working
+// directory, the executable and the application bundle, walking up to six
+// parents from each.
+//
+// Results (including misses) are memoised, so the directory walk happens once
+// per name rather than on every preset selection or editor open. Share one
+// instance through juce::SharedResourcePointer<ResourceLocator>.
+//
+// The folder holding the resolved ImageDerived.xml is watched; any change
+// there drops every cached result and the next lookup walks again. invalidate()
+// does the same on demand. All methods are thread-safe.
+class ResourceLocator
+{
+public:
+    ResourceLocator() = default;
+    ~ResourceLocator();
+
+    // "Unison Mod PRESETS"
+    juce::File getPresetImageRoot();
+
+    // "Presets/ImageDerived.xml"
+    juce::File getImageDerivedPresetFile();
+
+    // "Presets/<presetName>.xml", a factory preset stored as its own file
+    juce::File getFactoryPresetFile(const juce::String& presetName);
+
+    // fileName, assets/fileName or Assets/fileName
+    juce::File findAsset(const juce::String& fileName);
+
+    void invalidate() noexcept { stale.store(true); }
+
+private:
+    juce::File resolve(const juce::StringArray& relativePaths);
+    void buildSearchDirectories();
+    void watchDirectory(const juce::File& directory);
+
+    juce::CriticalSection lock;
+    juce::Array<juce::File> searchDirectories; // every candidate directory, in search order
+    std::map<juce::String, juce::File> resolved;
+    std::atomic<bool> stale { true };
+
+    juce::File watchedDirectory;
+    std::unique_ptr<DirectoryWatcher> watcher;
+    std::atomic<bool> watcherPrimed { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResourceLocator)
+};
@@ -0,0 +1,219 @@
+#include "UserPresetIndex.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr char magic[4] = { '3', 'V', 'U', 'I' };
+constexpr size_t headerSize = 24;
+constexpr size_t entrySize = 56;
+constexpr int numStringFields = 4;
+
+enum StringField
+{
+    nameField = 0,
+    categoryField,
+    tagsField,
+    fileNameField
+};
+
+size_t blobSizeFor(juce::uint64 mask) noexcept
+{
+    return sizeof(juce::uint64) + (size_t) juce::countNumberOfBits(mask) * sizeof(float);
+}
+
+void writeAt(juce::MemoryBlock& block, size_t offset, juce::uint32 value) noexcept
+{
+    auto* dest = static_cast<juce::uint8*>(block.getData()) + offset;
+    for (size_t i = 0; i < 4; ++i)
+        dest[i] = (juce::uint8) (value >> (8 * i));
+}
+} // namespace
+
+namespace UserPresetIndex
+{
+void write(const std::vector<Record>& records, juce::MemoryBlock& destData)
+{
+    juce::MemoryOutputStream strings;
+    juce::MemoryOutputStream blobs;
+    juce::MemoryOutputStream entries;
+
+    // Offsets are patched once the table sizes are known, so store them relative for now
+    for (const auto& record : records)
+    {
+        for (const auto* text : { &record.name, &record.category, &record.tags, &record.fileName })
+        {
+            const auto utf8Length = text->getNumBytesAsUTF8();
+            entries.writeInt((int) strings.getPosition());
+            entries.writeInt((int) utf8Length);
+            strings.write(text->toRawUTF8(), utf8Length);
+        }
+
+        entries.writeInt64(record.modificationTime);
+        entries.writeInt64(record.fileSize);
+        entries.writeInt((int) blobs.getPosition());
+        entries.writeInt((int) blobSizeFor(record.mask));
+
+        blobs.writeInt64((juce::int64) record.mask);
+        for (int i = 0; i < ParamIds::numParams; ++i)
+            if ((record.mask & (juce::uint64 { 1 } << i)) != 0)
+                blobs.writeFloat(record.values[(size_t) i]);
+    }
+
+    const auto stringsOffset = headerSize + entries.getDataSize();
+    const auto blobsOffset = stringsOffset + strings.getDataSize();
+    const auto totalSize = blobsOffset + blobs.getDataSize();
+
+    destData.setSize(totalSize, false);
+    {
+        juce::MemoryOutputStream out(destData, false);
+        out.write(magic, sizeof(magic));
+        out.writeShort((short) currentVersion);
+        out.writeShort(0);
+        out.writeInt((int) records.size());
+        out.writeInt((int) stringsOffset);
+        out.writeInt((int) blobsOffset);
+        out.writeInt((int) totalSize);
+        out.write(entries.getData(), entries.getDataSize());
+        out.write(strings.getData(), strings.getDataSize());
+        out.write(blobs.getData(), blobs.getDataSize());
+    }
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const auto base = headerSize + i * entrySize;
+        const auto* entryBytes = static_cast<const juce::uint8*>(destData.getData()) + base;
+
+        for (int field = 0; field < numStringFields; ++field)
+        {
+            const auto relative = juce::ByteOrder::littleEndianInt(entryBytes + field * 8);
+            writeAt(destData, base + (size_t) field * 8, (juce::uint32) stringsOffset + relative);
+        }
+
+        const auto blobRelative = juce::ByteOrder::littleEndianInt(entryBytes + 48);
+        writeAt(destData, base + 48, (juce::uint32) blobsOffset + blobRelative);
+    }
+}
+
+View::View(const void* data, size_t sizeInBytes)
+{
+    const auto* image = static_cast<const juce::uint8*>(data);
+    if (image == nullptr || sizeInBytes < headerSize || std::memcmp(image, magic, sizeof(magic)) != 0)
+        return;
+
+    const auto version = juce::ByteOrder::littleEndianShort(image + 4);
+    const auto count = (size_t) juce::ByteOrder::littleEndianInt(image + 8);
+    const auto totalSize = (size_t) juce::ByteOrder::littleEndianInt(image + 20);
+
+    if (version == 0 || version > currentVersion || totalSize != sizeInBytes
+        || count > (sizeInBytes - headerSize) / entrySize)
+        return;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto* entryBytes = image + headerSize + i * entrySize;
+
+        for (int field = 0; field < numStringFields; ++field)
+        {
+            const auto offset = (size_t) juce::ByteOrder::littleEndianInt(entryBytes + field * 8);
+            const auto length = (size_t) juce::ByteOrder::littleEndianInt(entryBytes + field * 8 + 4);
+            if (offset > sizeInBytes || length > sizeInBytes - offset)
+                return;
+        }
+
+        const auto blobOffset = (size_t) juce::ByteOrder::littleEndianInt(entryBytes + 48);
+        const auto blobSize = (size_t) juce::ByteOrder::littleEndianInt(entryBytes + 52);
+        if (blobOffset > sizeInBytes || blobSize > sizeInBytes - blobOffset || blobSize < sizeof(juce::uint64)
+            || blobSize != blobSizeFor(juce::ByteOrder::littleEndianInt64(image + blobOffset)))
+            return;
+    }
+
+    bytes = image;
+    size = sizeInBytes;
+    numEntries = (int) count;
+}
+
+const juce::uint8* View::entry(int index) const noexcept
+{
+    if (index < 0 || index >= numEntries)
+        return nullptr;
+    return bytes + headerSize + (size_t) index * entrySize;
+}
+
+juce::String View::getString(int index, int field) const
+{
+    const auto* entryBytes = entry(index);
+    if (entryBytes == nullptr)
+        return {};
+
+    const auto offset = juce::ByteOrder::littleEndianInt(entryBytes + field * 8);
+    const auto length = juce::ByteOrder::littleEndianInt(entryBytes + field * 8 + 4);
+    return juce::String::fromUTF8(reinterpret_cast<const char*>(bytes + offset), (int) length);
+}
+
+juce::String View::getName(int index) const     { return getString(index, nameField); }
+juce::String View::getCategory(int index) const { return getString(index, categoryField); }
+juce::String View::getTags(int index) const     { return getString(index, tagsField); }
+juce::String View::getFileName(int index) const { return getString(index, fileNameField); }
+
+juce::int64 View::getModificationTime(int index) const noexcept
+{
+    const auto* entryBytes = entry(index);
+    return entryBytes != nullptr ? (juce::int64) juce::ByteOrder::littleEndianInt64(entryBytes + 32) : 0;
+}
+
+juce::int64 View::getFileSize(int index) const noexcept
+{
+    const auto* entryBytes = entry(index);
+    return entryBytes != nullptr ? (juce::int64) juce::ByteOrder::littleEndianInt64(entryBytes + 40) : 0;
+}
+
+bool View::getValues(int index, ParameterValues& values) const noexcept
+{
+    const auto* entryBytes = entry(index);
+    if (entryBytes == nullptr)
+        return false;
+
+    const auto* blob = bytes + juce::ByteOrder::littleEndianInt(entryBytes + 48);
+    const auto mask = juce::ByteOrder::littleEndianInt64(blob);
+    blob += sizeof(juce::uint64);
+
+    // Bits past numParams come from a newer build and are skipped
+    for (int i = 0; i < 64; ++i)
+    {
+        if ((mask & (juce::uint64 { 1 } << i)) == 0)
+            continue;
+
+        if (i < ParamIds::numParams)
+        {
+            juce::uint32 raw = juce::ByteOrder::littleEndianInt(blob);
+            float value;
+            std::memcpy(&value, &raw, sizeof(value));
+            values[(size_t) i] = value;
+        }
+        blob += sizeof(float);
+    }
+
+    return true;
+}
+
+Record View::getRecord(int index) const
+{
+    Record record;
+    record.name = getName(index);
+    record.category = getCategory(index);
+    record.tags = getTags(index);
+    record.fileName = getFileName(index);
+    record.modificationTime = getModificationTime(index);
+    record.fileSize = getFileSize(index);
+
+    if (const auto* entryBytes = entry(index))
+    {
+        const auto mask = juce::ByteOrder::littleEndianInt64(bytes + juce::ByteOrder::littleEndianInt(entryBytes + 48));
+        record.mask = mask & ((juce::uint64 { 1 } << ParamIds::numParams) - 1);
+        getValues(index, record.values);
+    }
+
+    return record;
+}
+} // namespace UserPresetIndex
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "../state/ParameterSnapshot.h"
+
+// On-disk index of the user preset folder, built in the background and
+// memory-mapped for lookup, so listing or loading a preset never touches the
+// preset XML files themselves.
+//
+//   offset  size  field
+//   0       4     magic "3VUI"
+//   4       2     format version (little-endian)
+//   6       2     reserved
+//   8       4     entry count N
+//   12      4     string table offset
+//   16      4     parameter blob table offset
+//   20      4     total size in bytes
+//   24      56*N  entries:
+//                   4 x (u32 offset, u32 length) UTF-8 name, category, tags, file name
+//                   i64 file modification time (ms), i64 file size
+//                   u32 blob offset, u32 blob size
+//   ...           string table, then blobs: u64 mask of the parameters the
+//                 preset sets, followed by one float per set bit in index order
+//
+// All integers are little-endian. Entries are sorted by category, then name.
+namespace UserPresetIndex
+{
+constexpr juce::uint16 currentVersion = 1;
+
+struct Record
+{
+    juce::String name, category, tags, fileName;
+    juce::int64 modificationTime = 0;
+    juce::int64 fileSize = 0;
+    juce::uint64 mask = 0; // bit i set = values[i] comes from the preset
+    ParameterValues values {};
+};
+
+void write(const std::vector<Record>& records, juce::MemoryBlock& destData);
+
+// Read-only view over an index image (typically a juce::MemoryMappedFile).
+// Every offset is bounds-checked once on construction; an invalid image
+// behaves as an empty index.
+class View
+{
+public:
+    View() = default;
+    View(const void* data, size_t sizeInBytes);
+
+    bool isValid() const noexcept   { return bytes != nullptr; }
+    int getNumEntries() const noexcept { return numEntries; }
+
+    juce::String getName(int index) const;
+    juce::String getCategory(int index) const;
+    juce::String getTags(int index) const;
+    juce::String getFileName(int index) const;
+    juce::int64 getModificationTime(int index) const noexcept;
+    juce::int64 getFileSize(int index) const noexcept;
+
+    // Writes the parameters the preset sets into values; the rest keep theirs.
+    bool getValues(int index, ParameterValues& values) const noexcept;
+
+    Record getRecord(int index) const;
+
+private:
+    const juce::uint8* entry(int index) const noexcept;
+    juce::String getString(int index, int field) const;
+
+    const juce::uint8* bytes = nullptr;
+    size_t size = 0;
+    int numEntries = 0;
+};
+} // namespace UserPresetIndex
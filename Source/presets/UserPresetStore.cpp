@@ -0,0 +1,367 @@
+#include "UserPresetStore.h"
+#include "AtomicFileWrite.h"
+#include "PresetPackImporter.h"
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+const juce::String defaultCategory { "User" };
+
+bool parsePresetFile(const juce::File& file, UserPresetIndex::Record& record)
+{
+    const auto document = juce::XmlDocument::parse(file);
+    if (document == nullptr || !document->hasTagName("Parameters"))
+        return false;
+
+    record.fileName = file.getFileName();
+    record.name = document->getStringAttribute("name", file.getFileNameWithoutExtension()).trim();
+    record.category = document->getStringAttribute("category", defaultCategory).trim();
+    record.tags = document->getStringAttribute("tags").trim();
+    record.modificationTime = file.getLastModificationTime().toMilliseconds();
+    record.fileSize = file.getSize();
+    record.mask = 0;
+
+    forEachXmlChildElementWithTagName(*document, paramXml, "PARAM")
+    {
+        const auto index = ParamIds::find(paramXml->getStringAttribute("id").toRawUTF8());
+        if (index < 0)
+            continue;
+
+        record.values[(size_t) index] = (float) paramXml->getDoubleAttribute("value");
+        record.mask |= juce::uint64 { 1 } << index;
+    }
+
+    return true;
+}
+
+// Other instances (another editor, another host) share the folder and may
+// still be mapping the generations just before the newest, so only ones this
+// far behind it are deleted
+constexpr int generationsKept = 4;
+
+// 0 for anything that is not "index-<n>.bin", such as another writer's temp file
+int parseGeneration(const juce::File& indexFile)
+{
+    const auto name = indexFile.getFileNameWithoutExtension();
+    const auto number = name.fromFirstOccurrenceOf("index-", false, false);
+    if (!name.startsWith("index-") || number.isEmpty() || !number.containsOnly("0123456789")
+        || !indexFile.hasFileExtension("bin"))
+        return 0;
+    return number.getIntValue();
+}
+
+// A temp file left by a writer that never finished; one being written is recent
+bool isAbandonedTempFile(const juce::File& file)
+{
+    return file.getLastModificationTime() < juce::Time::getCurrentTime() - juce::RelativeTime::minutes(10);
+}
+} // namespace
+
+UserPresetStore::UserPresetStore(const juce::File& presetDirectory)
+    : directory(presetDirectory),
+      watcher(presetDirectory, [this](const juce::Array<juce::File>& changed) { handleDirectoryChange(changed); })
+{
+    // No disk access here: hosts construct the plugin to scan it, often many
+    // times over. Discovery starts on the watcher thread once the message loop
+    // turns, so an instance destroyed straight away never touches the library.
+    triggerAsyncUpdate();
+}
+
+UserPresetStore::~UserPresetStore()
+{
+    watcher.stop();
+    cancelPendingUpdate();
+}
+
+juce::File UserPresetStore::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("3 Voice Unison Mod")
+        .getChildFile("User Presets");
+}
+
+juce::File UserPresetStore::getIndexFile(int generation) const
+{
+    return getIndexDirectory().getChildFile("index-" + juce::String(generation) + ".bin");
+}
+
+int UserPresetStore::findPreset(const juce::String& name) const
+{
+    for (int i = 0; i < index.getNumEntries(); ++i)
+        if (index.getName(i).equalsIgnoreCase(name))
+            return i;
+    return -1;
+}
+
+juce::File UserPresetStore::savePreset(const juce::String& name, const juce::String& category,
+                                       const juce::String& tags, const ParameterValues& values)
+{
+    juce::XmlElement xml("Parameters");
+    xml.setAttribute("name", name);
+    xml.setAttribute("category", category.isNotEmpty() ? category : defaultCategory);
+    if (tags.isNotEmpty())
+        xml.setAttribute("tags", tags);
+
+    // The preset selector and morph position describe the session, not the sound
+    for (int i = 0; i < ParamIds::numParams; ++i)
+    {
+        if (i == ParamIds::presetChoice || i == ParamIds::morph)
+            continue;
+
+        auto* param = xml.createNewChildElement("PARAM");
+        param->setAttribute("id", ParamIds::ids[(size_t) i]);
+        param->setAttribute("value", values[(size_t) i]);
+    }
+
+    const auto file = directory.getChildFile(juce::File::createLegalFileName(name) + ".xml");
+    if (!directory.createDirectory() || !xml.writeTo(file))
+        return {};
+
+    return file;
+}
+
+void UserPresetStore::handleDirectoryChange(const juce::Array<juce::File>& changedFiles)
+{
+    if (!recordsLoaded)
+        loadLatestIndex();
+
+    auto findRecord = [this](const juce::String& fileName)
+    {
+        return std::find_if(records.begin(), records.end(),
+                            [&fileName](const UserPresetIndex::Record& r) { return r.fileName == fileName; });
+    };
+
+    bool changed = false;
+
+    // Re-parses one file if it differs from its record; drops the record if the file is gone or unreadable
+    auto refreshFile = [&](const juce::File& file)
+    {
+        auto existing = findRecord(file.getFileName());
+
+        if (existing != records.end() && file.existsAsFile()
+            && existing->modificationTime == file.getLastModificationTime().toMilliseconds()
+            && existing->fileSize == file.getSize())
+            return;
+
+        UserPresetIndex::Record record;
+        const bool parsed = file.existsAsFile() && parsePresetFile(file, record);
+
+        if (existing != records.end())
+        {
+            if (parsed)
+                *existing = std::move(record);
+            else
+                records.erase(existing);
+            changed = true;
+        }
+        else if (parsed)
+        {
+            records.push_back(std::move(record));
+            changed = true;
+        }
+    };
+
+    if (changedFiles.isEmpty())
+    {
+        // Full reconcile: unchanged files are recognised by time and size, not parsed
+        std::set<juce::String> present;
+        for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*.xml", juce::File::findFiles))
+        {
+            present.insert(entry.getFile().getFileName());
+            refreshFile(entry.getFile());
+        }
+
+        const auto oldSize = records.size();
+        records.erase(std::remove_if(records.begin(), records.end(),
+                                     [&present](const UserPresetIndex::Record& r) { return present.count(r.fileName) == 0; }),
+                      records.end());
+        changed = changed || records.size() != oldSize;
+
+        findPacks();
+    }
+    else
+    {
+        for (const auto& file : changedFiles)
+            refreshFile(file);
+    }
+
+    if (changed || writtenGeneration == 0)
+        publishIndex();
+}
+
+void UserPresetStore::loadLatestIndex()
+{
+    recordsLoaded = true;
+    directory.createDirectory();
+    getIndexDirectory().createDirectory();
+
+    // Start from the newest index generation and clear out ones well behind it
+    juce::Array<juce::File> indexFiles;
+    for (const auto& entry : juce::RangedDirectoryIterator(getIndexDirectory(), false, "index-*", juce::File::findFiles))
+        indexFiles.add(entry.getFile());
+
+    int generation = 0;
+    for (const auto& file : indexFiles)
+        generation = juce::jmax(generation, parseGeneration(file));
+
+    for (const auto& file : indexFiles)
+    {
+        const auto fileGeneration = parseGeneration(file);
+        if (fileGeneration > 0 ? fileGeneration <= generation - generationsKept : isAbandonedTempFile(file))
+            file.deleteFile();
+    }
+
+    if (generation == 0)
+        return;
+
+    juce::MemoryMappedFile existing(getIndexFile(generation), juce::MemoryMappedFile::readOnly);
+    const UserPresetIndex::View view(existing.getData(), existing.getSize());
+    if (!view.isValid())
+        return;
+
+    records.reserve((size_t) view.getNumEntries());
+    for (int i = 0; i < view.getNumEntries(); ++i)
+        records.push_back(view.getRecord(i));
+
+    // Let the message thread map it now; the reconcile that follows only
+    // writes a new generation if something changed on disk
+    writtenGeneration = generation;
+    latestGeneration.store(generation);
+    triggerAsyncUpdate();
+}
+
+void UserPresetStore::publishIndex()
+{
+    std::sort(records.begin(), records.end(), [](const UserPresetIndex::Record& a, const UserPresetIndex::Record& b)
+    {
+        if (const auto order = a.category.compareNatural(b.category); order != 0)
+            return order < 0;
+        return a.name.compareNatural(b.name) < 0;
+    });
+
+    juce::MemoryBlock image;
+    UserPresetIndex::write(records, image);
+
+    // Each generation is a new file, so a mapped one is never written underneath
+    // a reader. Other instances publish into the same folder: the number skips
+    // past any generation already there.
+    auto generation = writtenGeneration + 1;
+    while (getIndexFile(generation).exists())
+        ++generation;
+
+    if (!AtomicFileWrite::write(getIndexFile(generation), image.getData(), image.getSize()))
+        return;
+
+    writtenGeneration = generation;
+    latestGeneration.store(generation);
+    triggerAsyncUpdate();
+}
+
+void UserPresetStore::findPacks()
+{
+    juce::Array<juce::File> found;
+    if (getPackDirectory().isDirectory())
+        for (const auto& entry : juce::RangedDirectoryIterator(getPackDirectory(), false,
+                                                               juce::String("*") + PresetPackImporter::bundleExtension,
+                                                               juce::File::findFiles))
+            found.add(entry.getFile());
+    found.sort();
+
+    {
+        const juce::ScopedLock sl(foundPacksLock);
+        foundPacks.swapWith(found);
+        foundPacksPending = true;
+    }
+    triggerAsyncUpdate();
+}
+
+void UserPresetStore::handleAsyncUpdate()
+{
+    watcher.start();
+
+    const bool packsChanged = mapFoundPacks();
+    if (mapLatestIndex() || packsChanged)
+        sendChangeMessage();
+}
+
+bool UserPresetStore::mapLatestIndex()
+{
+    const auto generation = latestGeneration.load();
+    if (generation == mappedGeneration)
+        return false;
+
+    auto newMapping = std::make_unique<juce::MemoryMappedFile>(getIndexFile(generation), juce::MemoryMappedFile::readOnly);
+    UserPresetIndex::View newIndex(newMapping->getData(), newMapping->getSize());
+    if (!newIndex.isValid())
+        return false;
+
+    const auto previousGeneration = mappedGeneration;
+    index = newIndex;
+    mappedIndex = std::move(newMapping);
+    mappedGeneration = generation;
+
+    // Generations written in between were never mapped here, but another
+    // instance may have mapped them, so the most recent few are kept
+    for (auto g = juce::jmax(1, previousGeneration - generationsKept + 1); g <= generation - generationsKept; ++g)
+        getIndexFile(g).deleteFile();
+
+    return true;
+}
+
+bool UserPresetStore::mapFoundPacks()
+{
+    juce::Array<juce::File> found;
+    {
+        const juce::ScopedLock sl(foundPacksLock);
+        if (!foundPacksPending)
+            return false;
+        found.swapWith(foundPacks);
+        foundPacksPending = false;
+    }
+
+    packs.clear();
+    for (const auto& file : found)
+        addPack(file);
+    return true;
+}
+
+juce::String UserPresetStore::getPackName(int pack) const
+{
+    return juce::isPositiveAndBelow(pack, getNumPacks()) ? packs[(size_t) pack].file.getFileNameWithoutExtension() : juce::String();
+}
+
+const UserPresetIndex::View& UserPresetStore::getPack(int pack) const noexcept
+{
+    static const UserPresetIndex::View empty;
+    return juce::isPositiveAndBelow(pack, getNumPacks()) ? packs[(size_t) pack].view : empty;
+}
+
+bool UserPresetStore::getPackValues(int pack, int presetIndex, ParameterValues& values) const noexcept
+{
+    return getPack(pack).getValues(presetIndex, values);
+}
+
+void UserPresetStore::closePack(const juce::File& bundle)
+{
+    const auto oldSize = packs.size();
+    packs.erase(std::remove_if(packs.begin(), packs.end(), [&bundle](const MappedPack& p) { return p.file == bundle; }),
+                packs.end());
+
+    if (packs.size() != oldSize)
+        sendChangeMessage();
+}
+
+void UserPresetStore::addPack(const juce::File& bundle)
+{
+    // No parsing: the bundle is mapped and its offsets checked once by the View
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(bundle, juce::MemoryMappedFile::readOnly);
+    const UserPresetIndex::View view(mapping->getData(), mapping->getSize());
+    if (!view.isValid())
+        return;
+
+    closePack(bundle);
+    packs.push_back({ bundle, std::move(mapping), view });
+    sendChangeMessage();
+}
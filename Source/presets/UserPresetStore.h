@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <juce_events/juce_events.h>
+
+#include "DirectoryWatcher.h"
+#include "UserPresetIndex.h"
+
+// User presets: one XML file per preset in a single folder, fronted by a
+// memory-mapped binary index (UserPresetIndex).
+//
+// The message thread only ever reads the mapped index, so listing thousands
+// of presets or loading one costs no XML parsing and no directory scan. A
+// DirectoryWatcher keeps the index current in the background: only files it
+// reports as changed are re-parsed, a new index generation is written next to
+// the old one, and the message thread switches to it and broadcasts a change.
+// Several instances can share the folder: each new generation takes the next
+// unused number, temp files have unique names, and the last few generations
+// are kept for readers in other instances.
+//
+// Imported preset packs (PresetPackImporter bundles in "Packs/*.3vpack") are
+// already in the index format, so they are mapped and served the same way,
+// each as its own read-only list.
+//
+// Construction touches no disk. The library is discovered on the watcher
+// thread after the first message-loop turn; until then the store is empty.
+//
+// Preset file format matches the factory presets:
+//   <Parameters name="..." category="..." tags="a, b"> <PARAM id=".." value=".."/> ... </Parameters>
+class UserPresetStore : public juce::ChangeBroadcaster,
+                        private juce::AsyncUpdater
+{
+public:
+    explicit UserPresetStore(const juce::File& presetDirectory = getDefaultDirectory());
+    ~UserPresetStore() override;
+
+    static juce::File getDefaultDirectory();
+    const juce::File& getDirectory() const noexcept { return directory; }
+
+    // Message thread. Indices refer to the current index generation and are
+    // invalidated by a change message.
+    int getNumPresets() const noexcept { return index.getNumEntries(); }
+    juce::String getName(int presetIndex) const     { return index.getName(presetIndex); }
+    juce::String getCategory(int presetIndex) const { return index.getCategory(presetIndex); }
+    juce::String getTags(int presetIndex) const     { return index.getTags(presetIndex); }
+    int findPreset(const juce::String& name) const;
+
+    // Writes the parameters the preset sets into values; the rest keep theirs.
+    bool getValues(int presetIndex, ParameterValues& values) const noexcept { return index.getValues(presetIndex, values); }
+
+    // Message thread. Writes the preset file; the watcher indexes it.
+    juce::File savePreset(const juce::String& name, const juce::String& category,
+                          const juce::String& tags, const ParameterValues& values);
+
+    // Message thread. Pack indices are invalidated by a change message.
+    juce::File getPackDirectory() const { return directory.getChildFile("Packs"); }
+    int getNumPacks() const noexcept { return (int) packs.size(); }
+    juce::String getPackName(int pack) const;
+    const UserPresetIndex::View& getPack(int pack) const noexcept;
+    bool getPackValues(int pack, int presetIndex, ParameterValues& values) const noexcept;
+
+    // Message thread. Unmaps a bundle before it is rewritten (a mapped file
+    // cannot be replaced on Windows), and maps it again once it has been.
+    void closePack(const juce::File& bundle);
+    void addPack(const juce::File& bundle);
+
+private:
+    // Watcher thread
+    void handleDirectoryChange(const juce::Array<juce::File>& changedFiles);
+    void loadLatestIndex();
+    void publishIndex();
+
+    void findPacks();
+
+    void handleAsyncUpdate() override;
+    bool mapLatestIndex();
+    bool mapFoundPacks();
+    juce::File getIndexDirectory() const { return directory.getChildFile(".index"); }
+    juce::File getIndexFile(int generation) const;
+
+    const juce::File directory;
+
+    // Message thread: the mapped index in use
+    std::unique_ptr<juce::MemoryMappedFile> mappedIndex;
+    UserPresetIndex::View index;
+    int mappedGeneration = 0;
+
+    struct MappedPack
+    {
+        juce::File file;
+        std::unique_ptr<juce::MemoryMappedFile> mapping;
+        UserPresetIndex::View view;
+    };
+    std::vector<MappedPack> packs;
+
+    // Bundles found by the watcher thread's full scans, for the message thread to map
+    juce::CriticalSection foundPacksLock;
+    juce::Array<juce::File> foundPacks;
+    bool foundPacksPending = false;
+
+    // Watcher thread: authoritative records, and the newest generation written
+    std::vector<UserPresetIndex::Record> records;
+    bool recordsLoaded = false;
+    int writtenGeneration = 0;
+    std::atomic<int> latestGeneration { 0 };
+
+    DirectoryWatcher watcher; // last, so its thread stops before anything it uses is destroyed
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UserPresetStore)
+};
@@ -0,0 +1,120 @@
+#include "BinaryState.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr char magic[4] = { '3', 'V', 'U', 'S' };
+constexpr size_t headerSize = 8;
+constexpr size_t crcSize = 4;
+
+struct CrcTable
+{
+    CrcTable() noexcept
+    {
+        for (juce::uint32 i = 0; i < 256; ++i)
+        {
+            auto c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1u) != 0 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+
+    juce::uint32 entries[256];
+};
+} // namespace
+
+namespace BinaryState
+{
+juce::uint32 crc32(const void* data, size_t numBytes) noexcept
+{
+    static const CrcTable table;
+
+    auto crc = 0xffffffffu;
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    for (size_t i = 0; i < numBytes; ++i)
+        crc = table.entries[(crc ^ bytes[i]) & 0xffu] ^ (crc >> 8);
+    return crc ^ 0xffffffffu;
+}
+
+bool hasBinaryStateHeader(const void* data, size_t sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= headerSize + crcSize
+        && std::memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+void write(const ParameterValues& values, juce::MemoryBlock& destData,
+           const juce::StringPairArray& properties)
+{
+    // The stream trims destData to what was written when it goes out of
+    // scope, so the CRC has to be written through it as well
+    juce::MemoryOutputStream out(destData, false);
+    out.preallocate(headerSize + values.size() * sizeof(float) + crcSize);
+    out.write(magic, sizeof(magic));
+    out.writeShort((short) currentVersion);
+    out.writeShort((short) values.size());
+    for (const auto value : values)
+        out.writeFloat(value);
+
+    out.writeShort((short) properties.size());
+    for (int i = 0; i < properties.size(); ++i)
+    {
+        out.writeString(properties.getAllKeys()[i]);
+        out.writeString(properties.getAllValues()[i]);
+    }
+
+    out.writeInt((int) crc32(out.getData(), out.getDataSize()));
+}
+
+bool read(const void* data, size_t sizeInBytes, ParameterValues& values,
+          juce::StringPairArray* properties)
+{
+    if (!hasBinaryStateHeader(data, sizeInBytes))
+        return false;
+
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    const auto version = juce::ByteOrder::littleEndianShort(bytes + 4);
+    const auto count = (size_t) juce::ByteOrder::littleEndianShort(bytes + 6);
+    const auto valuesEnd = headerSize + count * sizeof(float);
+
+    // Version 1 ends at the values; later versions run to the end of the data
+    const auto payloadSize = version == 1 ? valuesEnd : sizeInBytes - crcSize;
+
+    if (version == 0 || version > currentVersion || sizeInBytes < valuesEnd + crcSize
+        || (version > 1 && payloadSize < valuesEnd + 2))
+        return false;
+
+    if (juce::ByteOrder::littleEndianInt(bytes + payloadSize) != crc32(bytes, payloadSize))
+        return false;
+
+    juce::StringPairArray readProperties;
+    if (version > 1)
+    {
+        juce::MemoryInputStream in(bytes + valuesEnd, payloadSize - valuesEnd, false);
+        const auto numProperties = (int) (juce::uint16) in.readShort();
+        for (int i = 0; i < numProperties; ++i)
+        {
+            if (in.isExhausted())
+                return false;
+
+            const auto key = in.readString();
+            const auto value = in.readString();
+            readProperties.set(key, value);
+        }
+    }
+
+    juce::MemoryInputStream in(bytes + headerSize, count * sizeof(float), false);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto value = in.readFloat();
+        if (i < values.size())
+            values[i] = value;
+    }
+
+    if (properties != nullptr)
+        *properties = readProperties;
+
+    return true;
+}
+} // namespace BinaryState
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "ParameterSnapshot.h"
+
+// Compact plugin state: every parameter value in ParamIds order.
+//
+//   offset  size  field
+//   0       4     magic "3VUS"
+//   4       2     format version (little-endian)
+//   6       2     parameter count N (little-endian)
+//   8       4*N   parameter values, little-endian IEEE floats
+//   8+4*N   2     property count M (version 2 onwards)
+//           ...   M key/value pairs, each a null-terminated UTF-8 string
+//   end-4   4     CRC-32 of all preceding bytes
+//
+// New parameters are only ever appended to ParamIds, so a reader fills
+// anything past N with defaults and a newer blob's extra values are ignored.
+// Properties carry the few non-parameter settings (file paths and the like);
+// version 1 blobs have none.
+namespace BinaryState
+{
+constexpr juce::uint16 currentVersion = 2;
+
+void write(const ParameterValues& values, juce::MemoryBlock& destData,
+           const juce::StringPairArray& properties = {});
+
+// Returns false if the data is not a binary state blob or is corrupt, in which
+// case values and properties are left untouched. Parameters the blob does not
+// contain keep whatever values holds on entry.
+bool read(const void* data, size_t sizeInBytes, ParameterValues& values,
+          juce::StringPairArray* properties = nullptr);
+
+bool hasBinaryStateHeader(const void* data, size_t sizeInBytes) noexcept;
+
+juce::uint32 crc32(const void* data, size_t numBytes) noexcept;
+} // namespace BinaryState
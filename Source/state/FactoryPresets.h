@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+
+#include <juce_core/juce_core.h>
+
+#include "ParameterSnapshot.h"
+
+// Factory presets compiled into the binary from the XML in Presets/ by
+// cmake/CompileFactoryPresets.cmake. The tables are indexed by catalog
+// position (the presetChoice value, see FactoryPresetList.h), so loading one
+// is an array lookup plus a copy into a ParameterValues array: no file
+// search, no XML parsing. Builds without the generated header (e.g. the
+// Projucer project) get isAvailable() == false.
+namespace FactoryPresets
+{
+struct Param
+{
+    int index; // ParamIds::Index, or -1 for an ID this build does not know
+    float value;
+};
+
+struct Preset
+{
+    int firstParam;
+    int numParams;
+    bool present; // false where no preset XML had an entry for the catalog preset
+};
+} // namespace FactoryPresets
+
+#if __has_include("FactoryPresetData.h")
+ #include "FactoryPresetData.h"
+#else
+namespace FactoryPresetData
+{
+inline constexpr bool available = false;
+inline constexpr std::array<FactoryPresets::Param, 0> params {};
+inline constexpr std::array<FactoryPresets::Preset, 0> presets {};
+} // namespace FactoryPresetData
+#endif
+
+namespace FactoryPresets
+{
+constexpr int numCatalogPresets = 0
+#define THREEVOICES_PRESET(category, name) + 1
+#include "../presets/FactoryPresetList.h"
+#undef THREEVOICES_PRESET
+    ;
+
+static_assert(!FactoryPresetData::available || FactoryPresetData::presets.size() == (size_t) numCatalogPresets,
+              "FactoryPresetData.h is out of date with FactoryPresetList.h");
+
+constexpr bool isAvailable() noexcept { return FactoryPresetData::available; }
+
+// Writes the catalog preset's parameters into values; parameters it does not
+// list are left as they are. Returns false, leaving values alone, when the
+// tables have no entry for it.
+inline bool apply(int catalogIndex, ParameterValues& values) noexcept
+{
+    if (!isAvailable() || catalogIndex < 0 || catalogIndex >= (int) FactoryPresetData::presets.size())
+        return false;
+
+    const auto& preset = FactoryPresetData::presets[(size_t) catalogIndex];
+    if (!preset.present)
+        return false;
+
+    for (int i = preset.firstParam; i < preset.firstParam + preset.numParams; ++i)
+    {
+        const auto& param = FactoryPresetData::params[(size_t) i];
+        if (param.index >= 0)
+            values[(size_t) param.index] = param.value;
+    }
+    return true;
+}
+} // namespace FactoryPresets
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+
+#include <juce_core/juce_core.h>
+
+#include "ParameterIds.h"
+
+// Lock-free "which parameters changed" set. Producers (host automation, audio
+// thread, message thread) only set a bit; the single consumer takes the whole
+// set once per UI frame, so UI cost follows frame rate, not automation density.
+class ParameterChangeBus
+{
+public:
+    static_assert(ParamIds::numParams <= 64, "ParameterChangeBus holds one bit per parameter");
+
+    void markDirty(ParamIds::Index index) noexcept
+    {
+        dirty.fetch_or(juce::uint64 { 1 } << index, std::memory_order_release);
+    }
+
+    // Everything changed at once (a restored state); consumers should redraw
+    // wholesale rather than walk the set.
+    void markAllDirty() noexcept
+    {
+        dirty.store(all, std::memory_order_release);
+    }
+
+    // Consumer only: returns and clears everything marked since the last call.
+    juce::uint64 consume() noexcept
+    {
+        return dirty.exchange(0, std::memory_order_acquire);
+    }
+
+    static bool contains(juce::uint64 set, ParamIds::Index index) noexcept
+    {
+        return (set & (juce::uint64 { 1 } << index)) != 0;
+    }
+
+    static bool isAll(juce::uint64 set) noexcept { return set == all; }
+
+private:
+    static constexpr juce::uint64 all = ~juce::uint64 { 0 };
+
+    std::atomic<juce::uint64> dirty { 0 };
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+
+// Dense index for every APVTS parameter, in createParameterLayout() order.
+// The processor resolves each ID to its std::atomic<float>* once at
+// construction, so realtime code indexes a table instead of hashing strings.
+namespace ParamIds
+{
+enum Index : int
+{
+    inputGain = 0,
+    outputGain,
+    mix,
+    width,
+
+    // Stable IDs used by the PNG-hitbox UI (legacy duplicates of the voice params)
+    speed,
+    delayTime,
+    depth,
+    distortion,
+    voice1,
+    voice2,
+    voice3,
+    distBit1,
+    distTube1,
+    distBit2,
+    distTube2,
+    distBit3,
+    distTube3,
+    presetChoice,
+
+    // Per-voice blocks, voiceStride entries each
+    voice1On,
+    voice1Speed,
+    voice1DelayTime,
+    voice1Depth,
+    voice1Distortion,
+    voice1Tube,
+    voice1Bit,
+    voice2On,
+    voice2Speed,
+    voice2DelayTime,
+    voice2Depth,
+    voice2Distortion,
+    voice2Tube,
+    voice2Bit,
+    voice3On,
+    voice3Speed,
+    voice3DelayTime,
+    voice3Depth,
+    voice3Distortion,
+    voice3Tube,
+    voice3Bit,
+
+    // Appended after the per-voice blocks (binary state only ever grows at the end)
+    morph,
+    cabType,
+    cabMix,
+
+    numParams
+};
+
+// Offsets inside a per-voice block
+enum VoiceParam : int
+{
+    voiceOn = 0,
+    voiceSpeed,
+    voiceDelayTime,
+    voiceDepth,
+    voiceDistortion,
+    voiceTube,
+    voiceBit,
+    voiceStride
+};
+
+constexpr Index forVoice(int voiceIndex, VoiceParam param) noexcept
+{
+    return (Index) (voice1On + voiceIndex * voiceStride + param);
+}
+
+constexpr Index legacyVoiceOn(int voiceIndex) noexcept   { return (Index) (voice1 + voiceIndex); }
+constexpr Index legacyVoiceTube(int voiceIndex) noexcept { return (Index) (distTube1 + voiceIndex * 2); }
+constexpr Index legacyVoiceBit(int voiceIndex) noexcept  { return (Index) (distBit1 + voiceIndex * 2); }
+
+inline constexpr std::array<const char*, numParams> ids {{
+    "inputGain", "outputGain", "mix", "width",
+    "speed", "delayTime", "depth", "distortion",
+    "voice1", "voice2", "voice3",
+    "dist_bit_1", "dist_tube_1", "dist_bit_2", "dist_tube_2", "dist_bit_3", "dist_tube_3",
+    "presetChoice",
+    "voice1On", "voice1Speed", "voice1DelayTime", "voice1Depth", "voice1Distortion", "voice1Tube", "voice1Bit",
+    "voice2On", "voice2Speed", "voice2DelayTime", "voice2Depth", "voice2Distortion", "voice2Tube", "voice2Bit",
+    "voice3On", "voice3Speed", "voice3DelayTime", "voice3Depth", "voice3Distortion", "voice3Tube", "voice3Bit",
+    "morph", "cabType", "cabMix"
+}};
+
+// Index for an ID string, or -1. constexpr so generated tables (the compiled
+// factory presets) resolve their IDs at compile time.
+constexpr int find(const char* id) noexcept
+{
+    for (int i = 0; i < numParams; ++i)
+    {
+        const char* a = ids[(size_t) i];
+        const char* b = id;
+        while (*a != 0 && *a == *b)
+        {
+            ++a;
+            ++b;
+        }
+        if (*a == *b)
+            return i;
+    }
+    return -1;
+}
+
+static_assert(forVoice(2, voiceBit) + 1 == morph, "per-voice block layout out of sync");
+} // namespace ParamIds
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <tuple>
+
+#include <juce_core/juce_core.h>
+
+#include "ParameterIds.h"
+
+// Denormalised value of every parameter, indexed by ParamIds::Index.
+using ParameterValues = std::array<float, ParamIds::numParams>;
+
+// Single-writer seqlock that hands a complete float array from the message
+// thread to the audio thread. While a snapshot is published the audio thread
+// reads it instead of the live parameters, so a preset that is still being
+// pushed into the APVTS is never seen half-applied.
+template <typename Values>
+class SeqlockExchange
+{
+public:
+    // Message thread.
+    void publish(const Values& newValues) noexcept
+    {
+        beginWrite();
+        for (size_t i = 0; i < newValues.size(); ++i)
+            values[i].store(newValues[i], std::memory_order_relaxed);
+        active.store(true, std::memory_order_relaxed);
+        endWrite();
+    }
+
+    // Message thread, once the live parameters hold the snapshot values.
+    void release() noexcept
+    {
+        beginWrite();
+        active.store(false, std::memory_order_relaxed);
+        endWrite();
+    }
+
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    // Audio thread (single reader). Returns false (leaving dest untouched) when
+    // nothing is published. The writer only holds the lock for a few dozen
+    // stores, so a torn read is retried, but at most maxReadAttempts times: if
+    // the writer is preempted mid-publish, dest is left as it was and the
+    // previous result is returned. Callers keep dest between calls, so that is
+    // the last complete snapshot they read.
+    bool read(Values& dest) noexcept
+    {
+        for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0)
+                continue;
+
+            if (!active.load(std::memory_order_relaxed))
+                return lastReadActive = false;
+
+            for (size_t i = 0; i < scratch.size(); ++i)
+                scratch[i] = values[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+            {
+                dest = scratch;
+                return lastReadActive = true;
+            }
+        }
+
+        return lastReadActive;
+    }
+
+private:
+    void beginWrite() noexcept
+    {
+        sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() noexcept
+    {
+        sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    static constexpr int maxReadAttempts = 16;
+
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<bool> active { false };
+    std::array<std::atomic<float>, std::tuple_size<Values>::value> values {};
+
+    // Reader side only
+    Values scratch {};
+    bool lastReadActive = false;
+};
+
+using ParameterSnapshotExchange = SeqlockExchange<ParameterValues>;
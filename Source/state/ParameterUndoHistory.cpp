@@ -0,0 +1,234 @@
+#include "ParameterUndoHistory.h"
+
+#include <algorithm>
+
+ParameterUndoHistory::ParameterUndoHistory(size_t memoryLimitBytes)
+    : memoryLimit(memoryLimitBytes)
+{
+}
+
+void ParameterUndoHistory::setMemoryLimit(size_t newLimitBytes)
+{
+    const juce::ScopedLock sl(lock);
+    memoryLimit = newLimitBytes;
+    enforceMemoryLimit();
+}
+
+size_t ParameterUndoHistory::getMemoryUsage() const
+{
+    const juce::ScopedLock sl(lock);
+    return getAllocatedBytes();
+}
+
+size_t ParameterUndoHistory::getAllocatedBytes() const
+{
+    return deltas.capacity() * sizeof(Delta) + transactionStarts.capacity() * sizeof(size_t);
+}
+
+void ParameterUndoHistory::beginGesture(int index, float currentValue)
+{
+    if (index < 0 || index >= ParamIds::numParams)
+        return;
+
+    const juce::ScopedLock sl(lock);
+    const auto bit = juce::uint64 { 1 } << index;
+    if ((activeGestures & bit) != 0)
+        return;
+
+    activeGestures |= bit;
+
+    // A second drag of the same control inside one transaction keeps the first "before"
+    const auto existing = std::find_if(pending.begin(), pending.end(),
+                                       [index](const Delta& d) { return d.index == index; });
+    if (existing == pending.end())
+        pending.push_back({ (juce::uint8) index, currentValue, currentValue });
+}
+
+void ParameterUndoHistory::endGesture(int index, float currentValue)
+{
+    if (index < 0 || index >= ParamIds::numParams)
+        return;
+
+    const juce::ScopedLock sl(lock);
+    const auto bit = juce::uint64 { 1 } << index;
+    if ((activeGestures & bit) == 0)
+        return;
+
+    activeGestures &= ~bit;
+
+    for (auto& delta : pending)
+        if (delta.index == index)
+            delta.after = currentValue;
+
+    if (activeGestures == 0)
+    {
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                     [](const Delta& d) { return d.before == d.after; }),
+                      pending.end());
+        commit(pending, true);
+        pending.clear();
+    }
+}
+
+void ParameterUndoHistory::recordTransaction(const ParameterValues& before, const ParameterValues& after)
+{
+    std::vector<Delta> changes;
+    for (size_t i = 0; i < before.size(); ++i)
+        if (before[i] != after[i])
+            changes.push_back({ (juce::uint8) i, before[i], after[i] });
+
+    const juce::ScopedLock sl(lock);
+    commit(changes, false);
+}
+
+void ParameterUndoHistory::commit(std::vector<Delta>& newDeltas, bool canMerge)
+{
+    if (newDeltas.empty())
+        return;
+
+    // A new edit discards the redo branch
+    if (numApplied < transactionStarts.size())
+    {
+        deltas.resize(transactionStarts[numApplied]);
+        transactionStarts.resize(numApplied);
+    }
+
+    // A recorded transaction leaves lastCommitTime at 0, so the next gesture
+    // does not merge into it either
+    const auto now = juce::Time::getMillisecondCounter();
+    const bool withinMergeWindow = lastCommitTime != 0 && now - lastCommitTime < mergeWindowMs;
+    lastCommitTime = canMerge ? now : 0;
+
+    if (canMerge && withinMergeWindow && tryMergeWithLast(newDeltas))
+        return;
+
+    transactionStarts.push_back(deltas.size());
+    deltas.insert(deltas.end(), newDeltas.begin(), newDeltas.end());
+    numApplied = transactionStarts.size();
+
+    enforceMemoryLimit();
+}
+
+bool ParameterUndoHistory::tryMergeWithLast(const std::vector<Delta>& newDeltas)
+{
+    if (transactionStarts.empty())
+        return false;
+
+    const auto start = transactionStarts.back();
+    if (deltas.size() - start != newDeltas.size())
+        return false;
+
+    for (size_t i = 0; i < newDeltas.size(); ++i)
+        if (deltas[start + i].index != newDeltas[i].index)
+            return false;
+
+    bool anyChange = false;
+    for (size_t i = 0; i < newDeltas.size(); ++i)
+    {
+        deltas[start + i].after = newDeltas[i].after;
+        anyChange = anyChange || deltas[start + i].before != deltas[start + i].after;
+    }
+
+    // e.g. a toggle clicked twice: nothing left to undo
+    if (!anyChange)
+    {
+        deltas.resize(start);
+        transactionStarts.pop_back();
+        numApplied = transactionStarts.size();
+    }
+
+    return true;
+}
+
+void ParameterUndoHistory::enforceMemoryLimit()
+{
+    // Vector growth can allocate up to twice what is in use, so the check is on
+    // capacity; trimming then shrinks the storage down to what is kept
+    if (getAllocatedBytes() <= memoryLimit)
+        return;
+
+    const auto bytesUsed = [this] { return deltas.size() * sizeof(Delta) + transactionStarts.size() * sizeof(size_t); };
+
+    // Drop the oldest transactions; always keep the most recent one
+    size_t numToDrop = 0;
+    size_t droppedDeltas = 0;
+    auto used = bytesUsed();
+
+    while (used > memoryLimit && numToDrop + 1 < transactionStarts.size())
+    {
+        const auto size = transactionStarts[numToDrop + 1] - transactionStarts[numToDrop];
+        used -= size * sizeof(Delta) + sizeof(size_t);
+        droppedDeltas += size;
+        ++numToDrop;
+    }
+
+    if (numToDrop > 0)
+    {
+        deltas.erase(deltas.begin(), deltas.begin() + (std::ptrdiff_t) droppedDeltas);
+        transactionStarts.erase(transactionStarts.begin(), transactionStarts.begin() + (std::ptrdiff_t) numToDrop);
+        for (auto& start : transactionStarts)
+            start -= droppedDeltas;
+
+        numApplied = numApplied > numToDrop ? numApplied - numToDrop : 0;
+    }
+
+    deltas.shrink_to_fit();
+    transactionStarts.shrink_to_fit();
+}
+
+bool ParameterUndoHistory::undo(ParameterValues& values)
+{
+    const juce::ScopedLock sl(lock);
+    if (numApplied == 0 || activeGestures != 0)
+        return false;
+
+    --numApplied;
+    const auto begin = transactionStarts[numApplied];
+    const auto end = numApplied + 1 < transactionStarts.size() ? transactionStarts[numApplied + 1] : deltas.size();
+
+    for (auto i = begin; i < end; ++i)
+        values[deltas[i].index] = deltas[i].before;
+
+    lastCommitTime = 0; // the next edit never merges into an undone step
+    return true;
+}
+
+bool ParameterUndoHistory::redo(ParameterValues& values)
+{
+    const juce::ScopedLock sl(lock);
+    if (numApplied >= transactionStarts.size() || activeGestures != 0)
+        return false;
+
+    const auto begin = transactionStarts[numApplied];
+    const auto end = numApplied + 1 < transactionStarts.size() ? transactionStarts[numApplied + 1] : deltas.size();
+
+    for (auto i = begin; i < end; ++i)
+        values[deltas[i].index] = deltas[i].after;
+
+    ++numApplied;
+    lastCommitTime = 0;
+    return true;
+}
+
+bool ParameterUndoHistory::canUndo() const
+{
+    const juce::ScopedLock sl(lock);
+    return numApplied > 0;
+}
+
+bool ParameterUndoHistory::canRedo() const
+{
+    const juce::ScopedLock sl(lock);
+    return numApplied < transactionStarts.size();
+}
+
+void ParameterUndoHistory::clear()
+{
+    const juce::ScopedLock sl(lock);
+    deltas.clear();
+    transactionStarts.clear();
+    numApplied = 0;
+    activeGestures = 0;
+    pending.clear();
+    lastCommitTime = 0;
+}
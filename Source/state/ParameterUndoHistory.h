@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "ParameterSnapshot.h"
+
+// Undo/redo for parameter edits, stored as compact deltas (index + before/after)
+// rather than whole-state snapshots, with a hard memory cap per instance.
+//
+// A transaction is everything between the first gesture begin and the last
+// gesture end, so a knob drag (or dragging two controls at once) is one step.
+// Back-to-back gesture transactions on the same parameters within mergeWindowMs
+// (mouse-wheel nudges, repeated clicks) fold into one. Recorded transactions
+// (preset loads) never merge, in either direction.
+//
+// The memory cap applies to the storage actually allocated, not just the part
+// in use.
+//
+// Never touched by the audio thread.
+class ParameterUndoHistory
+{
+public:
+    struct Delta
+    {
+        juce::uint8 index;
+        float before;
+        float after;
+    };
+
+    static constexpr size_t defaultMemoryLimitBytes = 32 * 1024;
+    static constexpr juce::uint32 mergeWindowMs = 500;
+
+    explicit ParameterUndoHistory(size_t memoryLimitBytes = defaultMemoryLimitBytes);
+
+    void setMemoryLimit(size_t newLimitBytes);
+    size_t getMemoryUsage() const;
+
+    // Gesture tracking; currentValue is the parameter's value at that moment.
+    void beginGesture(int index, float currentValue);
+    void endGesture(int index, float currentValue);
+
+    // Records a change made outside a gesture, e.g. a preset load.
+    void recordTransaction(const ParameterValues& before, const ParameterValues& after);
+
+    // Writes the previous / next state of the affected parameters into values.
+    bool undo(ParameterValues& values);
+    bool redo(ParameterValues& values);
+
+    bool canUndo() const;
+    bool canRedo() const;
+    void clear();
+
+private:
+    void commit(std::vector<Delta>& newDeltas, bool canMerge);
+    bool tryMergeWithLast(const std::vector<Delta>& newDeltas);
+    void enforceMemoryLimit();
+    size_t getAllocatedBytes() const; // caller holds lock
+
+    mutable juce::CriticalSection lock;
+
+    std::vector<Delta> deltas;               // every transaction, oldest first
+    std::vector<size_t> transactionStarts;   // offset of each transaction in deltas
+    size_t numApplied = 0;                   // transactions currently applied (undo cursor)
+    juce::uint32 lastCommitTime = 0;
+    size_t memoryLimit;
+
+    // Open gesture transaction
+    juce::uint64 activeGestures = 0;
+    std::vector<Delta> pending;
+};
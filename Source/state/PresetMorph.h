@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "ParameterSnapshot.h"
+
+// Continuous morph between two resolved parameter snapshots (A and B).
+//
+// The message thread stores A and (B - A) once; the audio thread then gets
+// every morphed value with one vector multiply-add per block. Discrete
+// parameters (switches, choices) flip at the halfway point instead of being
+// interpolated. Nothing is written back to the APVTS while morphing.
+class PresetMorph
+{
+public:
+    // Message thread, before use: which parameters are discrete and which
+    // follow the morph at all (the rest always follow the live parameter).
+    void setParameterKinds(juce::uint64 discreteMask, juce::uint64 morphableMask) noexcept
+    {
+        discrete = discreteMask;
+        morphable = morphableMask;
+    }
+
+    bool isMorphable(ParamIds::Index index) const noexcept
+    {
+        return (morphable & (juce::uint64 { 1 } << index)) != 0;
+    }
+
+    // Message thread. Enables the morph with the given endpoints.
+    void setTargets(const ParameterValues& a, const ParameterValues& b) noexcept
+    {
+        Targets targets {};
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            targets[i] = a[i];
+            targets[i + a.size()] = b[i] - a[i];
+        }
+
+        lastTargets = targets;
+        exchange.publish(targets);
+    }
+
+    // Message thread.
+    void disable() noexcept  { exchange.release(); }
+    bool isEnabled() const noexcept { return exchange.isActive(); }
+
+    // Message thread: the morphed values for the last published targets.
+    ParameterValues evaluate(float amount) const noexcept
+    {
+        ParameterValues out {};
+        interpolate(lastTargets, amount, out);
+        return out;
+    }
+
+    // Audio thread. Returns false when no morph is active.
+    bool process(float amount, ParameterValues& out) noexcept
+    {
+        if (!exchange.read(audioTargets))
+            return false;
+
+        interpolate(audioTargets, amount, out);
+        return true;
+    }
+
+private:
+    using Targets = std::array<float, 2 * ParamIds::numParams>;
+
+    void interpolate(const Targets& targets, float amount, ParameterValues& out) const noexcept
+    {
+        amount = juce::jlimit(0.0f, 1.0f, amount);
+        const auto* base = targets.data();
+        const auto* delta = targets.data() + ParamIds::numParams;
+
+        juce::FloatVectorOperations::copy(out.data(), base, ParamIds::numParams);
+        juce::FloatVectorOperations::addWithMultiply(out.data(), delta, amount, ParamIds::numParams);
+
+        for (int i = 0; i < ParamIds::numParams; ++i)
+            if ((discrete & (juce::uint64 { 1 } << i)) != 0)
+                out[(size_t) i] = amount < 0.5f ? base[i] : base[i] + delta[i];
+    }
+
+    SeqlockExchange<Targets> exchange;
+    Targets audioTargets {};
+    Targets lastTargets {};
+    juce::uint64 discrete = 0;
+    juce::uint64 morphable = 0;
+};
@@ -1,6 +1,57 @@
 #include "PresetMenuOverlay.h"
 
 #include <cmath>
+#include <iterator>
+
+namespace
+{
+constexpr int maxSearchResults = 500;
+
+void drawDisplayText(juce::Graphics& g, const juce::String& text, juce::Rectangle<int> area, juce::Justification justification)
+{
+    auto font = juce::Font(juce::FontOptions(area.getHeight() * 0.58f));
+    font.setHorizontalScale(1.12f);
+    g.setFont(font);
+
+    g.setColour(juce::Colour(0xFF53E68A).withAlpha(0.14f));
+    g.drawFittedText(text, area.translated(0, 1), justification, 1);
+    g.setColour(juce::Colour(0xFF7AF5A4).withAlpha(0.12f));
+    g.drawFittedText(text, area.expanded(2, 0), justification, 1);
+    g.setColour(juce::Colour(0xFF79F79D));
+    g.drawFittedText(text, area, justification, 1);
+}
+
+enum class AuditionGlyph { none, play, stop };
+
+void drawRow(juce::Graphics& g, juce::Rectangle<float> row, const juce::String& text,
+             AuditionGlyph glyph = AuditionGlyph::none, float glyphWidth = 0.0f)
+{
+    g.setColour(juce::Colours::white.withAlpha(0.04f));
+    g.fillRoundedRectangle(row, 6.0f);
+    g.setColour(juce::Colour(0xFF79F79D).withAlpha(0.12f));
+    g.drawRoundedRectangle(row.reduced(0.8f), 6.0f, 0.8f);
+
+    if (glyph != AuditionGlyph::none)
+    {
+        const auto area = row.removeFromRight(glyphWidth);
+        const auto box = area.withSizeKeepingCentre(area.getHeight() * 0.36f, area.getHeight() * 0.36f);
+        g.setColour(juce::Colour(0xFF79F79D).withAlpha(glyph == AuditionGlyph::stop ? 1.0f : 0.6f));
+
+        if (glyph == AuditionGlyph::stop)
+        {
+            g.fillRect(box);
+        }
+        else
+        {
+            juce::Path triangle;
+            triangle.addTriangle(box.getTopLeft(), box.getBottomLeft(), { box.getRight(), box.getCentreY() });
+            g.fillPath(triangle);
+        }
+    }
+
+    drawDisplayText(g, text.toUpperCase(), row.toNearestInt().reduced(14, 0), juce::Justification::centredLeft);
+}
+} // namespace
 
 PresetMenuOverlay::PresetMenuOverlay()
 {
@@ -8,11 +59,13 @@ PresetMenuOverlay::PresetMenuOverlay()
     setWantsKeyboardFocus(true);
     setInterceptsMouseClicks(true, true);
 
-    for (int i = 0; i < 6; ++i)
-        categoryRowRectsRef[(size_t) i] = { 24, 27 + i * 49, 585, 43 };
+    scroll.addListener(this);
+}
 
-    for (int i = 0; i < 10; ++i)
-        presetRowRectsRef[(size_t) i] = { 24, 27 + i * 49, 585, 43 };
+PresetMenuOverlay::~PresetMenuOverlay()
+{
+    if (userPresets != nullptr)
+        userPresets->removeChangeListener(this);
 }
 
 void PresetMenuOverlay::setMenuImages(const juce::Image*,
@@ -25,31 +78,27 @@ void PresetMenuOverlay::setMenuImages(const juce::Image*,
 {
 }
 
-void PresetMenuOverlay::setPresetLibrary(const juce::StringArray& flattenedChoices)
+void PresetMenuOverlay::setPresetLibrary(const PresetCatalog& newCatalog)
 {
-    categoryNames.clear();
-    presetsByCategory.clear();
+    if (catalog == &newCatalog)
+        return;
 
-    for (const auto& choice : flattenedChoices)
-    {
-        const auto separator = choice.indexOf(" - ");
-        if (separator < 0)
-            continue;
+    catalog = &newCatalog;
+    showList(-1);
+}
 
-        const auto category = choice.substring(0, separator).trim();
-        const auto preset = choice.substring(separator + 3).trim();
-        const int categoryIndex = categoryNames.indexOf(category);
+void PresetMenuOverlay::setUserPresets(UserPresetStore& store)
+{
+    if (userPresets == &store)
+        return;
 
-        if (categoryIndex < 0)
-        {
-            categoryNames.add(category);
-            presetsByCategory.push_back({ preset });
-        }
-        else
-        {
-            presetsByCategory[(size_t) categoryIndex].add(preset);
-        }
-    }
+    if (userPresets != nullptr)
+        userPresets->removeChangeListener(this);
+
+    userPresets = &store;
+    userPresets->addChangeListener(this);
+    rebuildLibrarySearch();
+    showList(-1);
 }
 
 void PresetMenuOverlay::setCallbacks(PresetSelected onPresetSelectedIn, Closed onClosedIn)
@@ -58,35 +107,47 @@ void PresetMenuOverlay::setCallbacks(PresetSelected onPresetSelectedIn, Closed o
     onClosed = std::move(onClosedIn);
 }
 
+void PresetMenuOverlay::setLibraryCallback(LibraryPresetSelected onLibraryPresetSelectedIn)
+{
+    onLibraryPresetSelected = std::move(onLibraryPresetSelectedIn);
+}
+
+void PresetMenuOverlay::setAuditionCallback(PresetAuditioned onPresetAuditionedIn)
+{
+    onPresetAuditioned = std::move(onPresetAuditionedIn);
+    rowCache.clear();
+    repaint();
+}
+
+void PresetMenuOverlay::setAuditioningPreset(int presetIndex)
+{
+    if (auditioningPreset == presetIndex)
+        return;
+
+    auditioningPreset = presetIndex;
+    rowCache.clear();
+    repaint();
+}
+
 void PresetMenuOverlay::openCategories()
 {
-    currentCategory = -1;
+    searchQuery.clear();
+    searchResults.clear();
+    showList(-1);
     setVisible(true);
     toFront(true);
     grabKeyboardFocus();
-    repaint();
 }
 
 void PresetMenuOverlay::paint(juce::Graphics& g)
 {
-    auto menuScaled = scaleRect(getCurrentMenuRectRef()).toFloat();
+    const auto menuRect = scaleRect(getCurrentMenuRectRef());
+    auto menuScaled = menuRect.toFloat();
     const float corner = menuScaled.getHeight() * 0.045f;
-    const auto currentTitle = currentCategory < 0 ? juce::String("SELECT CATEGORY")
-                                                  : categoryNames[currentCategory].toUpperCase();
-
-    auto drawDisplayText = [&g](juce::String text, juce::Rectangle<int> area, juce::Justification justification)
-    {
-        auto font = juce::Font(juce::FontOptions(area.getHeight() * 0.58f));
-        font.setHorizontalScale(1.12f);
-        g.setFont(font);
-
-        g.setColour(juce::Colour(0xFF53E68A).withAlpha(0.14f));
-        g.drawFittedText(text, area.translated(0, 1), justification, 1);
-        g.setColour(juce::Colour(0xFF7AF5A4).withAlpha(0.12f));
-        g.drawFittedText(text, area.expanded(2, 0), justification, 1);
-        g.setColour(juce::Colour(0xFF79F79D));
-        g.drawFittedText(text, area, justification, 1);
-    };
+    const auto currentTitle = isSearching()            ? "SEARCH: " + searchQuery.toUpperCase()
+                            : currentCategory < 0      ? juce::String("SELECT CATEGORY")
+                            : getCurrentLibrary() >= 0 ? getLibraryName(getCurrentLibrary()).toUpperCase()
+                                                       : catalog->getCategory(currentCategory).name.toUpperCase();
 
     g.setColour(juce::Colours::black.withAlpha(0.72f));
     g.fillRoundedRectangle(menuScaled, corner);
@@ -94,109 +155,180 @@ void PresetMenuOverlay::paint(juce::Graphics& g)
     g.drawRoundedRectangle(menuScaled.reduced(1.5f), corner, 1.0f);
 
     auto titleArea = menuScaled.removeFromTop(menuScaled.getHeight() * 0.09f);
-    drawDisplayText(currentTitle, titleArea.toNearestInt().reduced(14, 2), juce::Justification::centredLeft);
+    drawDisplayText(g, currentTitle, titleArea.toNearestInt().reduced(14, 2), juce::Justification::centredLeft);
 
-    if (currentCategory >= 0)
+    if (currentCategory >= 0 || isSearching())
     {
         const auto backArea = scaleRect(backRectRef);
-        drawDisplayText("< BACK",
+        drawDisplayText(g, "< BACK",
                         backArea.translated((int) std::round(menuScaled.getX()),
                                             (int) std::round(menuScaled.getY())).toNearestInt(),
                         juce::Justification::centredLeft);
     }
 
-    const auto rowBase = scaleRect(getCurrentMenuRectRef()).getPosition();
+    // Only the rows inside the list window are drawn
+    const auto scale = getMenuScale();
+    auto toScreen = [&menuRect, scale](float xRef, float yRef, float wRef, float hRef)
+    {
+        return juce::Rectangle<float>(menuRect.getX() + xRef * scale, menuRect.getY() + yRef * scale,
+                                      wRef * scale, hRef * scale);
+    };
+
+    const auto listHeight = getListHeightRef();
+    juce::Graphics::ScopedSaveState clip(g);
+    g.reduceClipRegion(toScreen(0.0f, (float) firstRowYRef, (float) menuRect.getWidth() / scale, listHeight).toNearestInt());
 
-    if (currentCategory < 0)
+    const int numRows = getNumRows();
+    if (numRows == 0 && (isSearching() || getCurrentLibrary() >= 0))
     {
-        for (int i = 0; i < categoryNames.size() && i < (int) categoryRowRectsRef.size(); ++i)
-        {
-            const auto row = scaleRect(categoryRowRectsRef[(size_t) i]).translated(rowBase.x, rowBase.y).toFloat();
-            g.setColour(juce::Colours::white.withAlpha(0.04f));
-            g.fillRoundedRectangle(row, 6.0f);
-            g.setColour(juce::Colour(0xFF79F79D).withAlpha(0.12f));
-            g.drawRoundedRectangle(row.reduced(0.8f), 6.0f, 0.8f);
-            drawDisplayText(categoryNames[i].toUpperCase(), row.toNearestInt().reduced(14, 0),
-                            juce::Justification::centredLeft);
-        }
+        drawRow(g, toScreen((float) rowXRef, (float) firstRowYRef, (float) rowWidthRef, (float) rowHeightRef),
+                isSearching() ? "No matches" : "No presets");
         return;
     }
 
-    const auto& presets = presetsByCategory[(size_t) currentCategory];
-    for (int i = 0; i < presets.size() && i < (int) presetRowRectsRef.size(); ++i)
+    const int firstVisible = juce::jmax(0, (int) (scrollOffsetRef / rowPitchRef));
+    const int lastVisible = juce::jmin(numRows - 1, (int) ((scrollOffsetRef + listHeight) / rowPitchRef));
+
+    for (int row = firstVisible; row <= lastVisible; ++row)
     {
-        const auto row = scaleRect(presetRowRectsRef[(size_t) i]).translated(rowBase.x, rowBase.y).toFloat();
-        g.setColour(juce::Colours::white.withAlpha(0.04f));
-        g.fillRoundedRectangle(row, 6.0f);
-        g.setColour(juce::Colour(0xFF79F79D).withAlpha(0.12f));
-        g.drawRoundedRectangle(row.reduced(0.8f), 6.0f, 0.8f);
-        drawDisplayText(presets[i].toUpperCase(), row.toNearestInt().reduced(14, 0),
-                        juce::Justification::centredLeft);
+        const auto yRef = (float) (firstRowYRef + row * rowPitchRef - scrollOffsetRef);
+        const auto bounds = toScreen((float) rowXRef, yRef, (float) rowWidthRef, (float) rowHeightRef);
+        const auto physicalScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const auto& image = getRowImage(row, (bounds * physicalScale).toNearestInt());
+        g.drawImage(image, bounds);
+    }
+
+    // Keep the cache to the rows around the window
+    if ((int) rowCache.size() > maxCachedRows)
+    {
+        const int keepFrom = firstVisible - maxCachedRows / 4;
+        const int keepTo = lastVisible + maxCachedRows / 4;
+        for (auto it = rowCache.begin(); it != rowCache.end();)
+            it = (it->first < keepFrom || it->first > keepTo) ? rowCache.erase(it) : std::next(it);
     }
 }
 
+const juce::Image& PresetMenuOverlay::getRowImage(int row, juce::Rectangle<int> scaledRowBounds)
+{
+    const int width = juce::jmax(1, scaledRowBounds.getWidth());
+    const int height = juce::jmax(1, scaledRowBounds.getHeight());
+
+    if (width != rowCacheWidth)
+    {
+        rowCache.clear();
+        rowCacheWidth = width;
+    }
+
+    auto& image = rowCache[row];
+    if (!image.isValid())
+    {
+        image = juce::Image(juce::Image::ARGB, width, height, true);
+        juce::Graphics rowGraphics(image);
+        const auto presetIndex = getRowPresetIndex(row);
+        const auto glyph = presetIndex < 0 || !onPresetAuditioned ? AuditionGlyph::none
+                         : presetIndex == auditioningPreset      ? AuditionGlyph::stop
+                                                                 : AuditionGlyph::play;
+        drawRow(rowGraphics, image.getBounds().toFloat(), getRowText(row),
+                glyph, (float) width * auditionButtonWidthRef / rowWidthRef);
+    }
+    return image;
+}
+
 void PresetMenuOverlay::resized()
 {
+    rowCache.clear();
     repaint();
 }
 
+void PresetMenuOverlay::mouseDown(const juce::MouseEvent&)
+{
+    isDraggingList = false;
+    scroll.beginDrag();
+}
+
+void PresetMenuOverlay::mouseDrag(const juce::MouseEvent& event)
+{
+    if (!isDraggingList && std::abs(event.getDistanceFromDragStartY()) > dragThresholdPx)
+        isDraggingList = true;
+
+    if (isDraggingList)
+        scroll.drag(-event.getDistanceFromDragStartY() / (double) getMenuScale());
+}
+
 void PresetMenuOverlay::mouseUp(const juce::MouseEvent& event)
 {
-    const auto screenMenuRef = getCurrentMenuRectRef();
-    const auto screenMenuRect = scaleRect(screenMenuRef);
+    // A drag releases into momentum scrolling; only a still click selects
+    scroll.endDrag();
+    if (isDraggingList)
+    {
+        isDraggingList = false;
+        return;
+    }
 
-    if (!screenMenuRect.contains(event.getPosition()))
+    if (!scaleRect(getCurrentMenuRectRef()).contains(event.getPosition()))
     {
         if (onClosed)
             onClosed();
         return;
     }
 
-    const auto scaleX = screenMenuRect.getWidth() / (float) screenMenuRef.getWidth();
-    const auto scaleY = screenMenuRect.getHeight() / (float) screenMenuRef.getHeight();
-
-    const int localX = (int) std::round((event.x - screenMenuRect.getX()) / juce::jmax(0.001f, scaleX));
-    const int localY = (int) std::round((event.y - screenMenuRect.getY()) / juce::jmax(0.001f, scaleY));
-    const juce::Point<int> localPt { localX, localY };
+    const auto menuPosition = toMenuRef(event.getPosition());
 
-    if (currentCategory < 0)
+    if ((currentCategory >= 0 || isSearching()) && backRectRef.toFloat().contains(menuPosition))
     {
-        for (int i = 0; i < categoryNames.size() && i < (int) categoryRowRectsRef.size(); ++i)
-        {
-            if (categoryRowRectsRef[(size_t) i].contains(localPt))
-            {
-                currentCategory = i;
-                repaint();
-                return;
-            }
-        }
+        if (isSearching())
+            setSearchQuery({});
+        else
+            showList(-1);
         return;
     }
 
-    if (backRectRef.contains(localPt))
+    if (const int row = getRowAt(menuPosition); row >= 0)
     {
-        currentCategory = -1;
-        repaint();
-        return;
+        const auto presetIndex = getRowPresetIndex(row);
+        if (presetIndex >= 0 && onPresetAuditioned
+            && menuPosition.x >= rowXRef + rowWidthRef - auditionButtonWidthRef)
+            onPresetAuditioned(presetIndex == auditioningPreset ? -1 : presetIndex);
+        else
+            activateRow(row);
     }
+}
 
-    const auto& presets = presetsByCategory[(size_t) currentCategory];
-    for (int i = 0; i < presets.size() && i < (int) presetRowRectsRef.size(); ++i)
-    {
-        if (presetRowRectsRef[(size_t) i].contains(localPt))
-        {
-            if (onPresetSelected)
-                onPresetSelected(currentCategory, i);
-
-            if (onClosed)
-                onClosed();
-            return;
-        }
-    }
+void PresetMenuOverlay::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    scroll.nudge(-wheel.deltaY * rowPitchRef * 6.0);
 }
 
 bool PresetMenuOverlay::keyPressed(const juce::KeyPress& key)
 {
+    // Typing searches the whole catalog; Escape clears the search first
+    if (key == juce::KeyPress::escapeKey && isSearching())
+    {
+        setSearchQuery({});
+        return true;
+    }
+
+    if (key == juce::KeyPress::backspaceKey)
+    {
+        if (isSearching())
+            setSearchQuery(searchQuery.dropLastCharacters(1));
+        return true;
+    }
+
+    if (key == juce::KeyPress::upKey || key == juce::KeyPress::downKey)
+    {
+        scroll.nudge(key == juce::KeyPress::upKey ? -rowPitchRef : rowPitchRef);
+        return true;
+    }
+
+    if (const auto character = key.getTextCharacter();
+        character >= ' ' && !key.getModifiers().isCommandDown() && !key.getModifiers().isCtrlDown())
+    {
+        if (character != ' ' || isSearching())
+            setSearchQuery(searchQuery + juce::String::charToString(character));
+        return true;
+    }
+
     if (key == juce::KeyPress::escapeKey)
     {
         if (currentCategory < 0)
@@ -206,8 +338,7 @@ bool PresetMenuOverlay::keyPressed(const juce::KeyPress& key)
         }
         else
         {
-            currentCategory = -1;
-            repaint();
+            showList(-1);
         }
         return true;
     }
@@ -233,5 +364,214 @@ juce::Rectangle<int> PresetMenuOverlay::scaleRect(const juce::Rectangle<int>& re
 
 juce::Rectangle<int> PresetMenuOverlay::getCurrentMenuRectRef() const
 {
-    return currentCategory < 0 ? categoriesMenuRef : presetsMenuRef;
+    return currentCategory < 0 && !isSearching() ? categoriesMenuRef : presetsMenuRef;
+}
+
+float PresetMenuOverlay::getMenuScale() const
+{
+    const auto menuRef = getCurrentMenuRectRef();
+    return juce::jmax(0.001f, scaleRect(menuRef).getHeight() / (float) menuRef.getHeight());
+}
+
+juce::Point<float> PresetMenuOverlay::toMenuRef(juce::Point<int> position) const
+{
+    const auto menuRect = scaleRect(getCurrentMenuRectRef());
+    const auto scale = getMenuScale();
+    return { (position.x - menuRect.getX()) / scale, (position.y - menuRect.getY()) / scale };
+}
+
+void PresetMenuOverlay::setSearchQuery(const juce::String& newQuery)
+{
+    searchQuery = newQuery;
+    searchResults.clear();
+
+    if (searchQuery.isNotEmpty())
+    {
+        // The user's own presets are few and the likelier target, so they lead
+        for (const auto document : librarySearchIndex.search(searchQuery, maxSearchResults))
+            searchResults.push_back(librarySearchDocuments[(size_t) document]);
+
+        if (catalog != nullptr)
+            for (const auto presetIndex : catalog->getSearchIndex().search(searchQuery, maxSearchResults - (int) searchResults.size()))
+                searchResults.push_back({ factoryLibrary, presetIndex });
+    }
+
+    showList(currentCategory);
+}
+
+juce::String PresetMenuOverlay::getLibraryName(int library) const
+{
+    if (library == userLibrary)
+        return "User Presets";
+    return userPresets != nullptr ? "Pack: " + userPresets->getPackName(library - firstPackLibrary) : juce::String();
+}
+
+int PresetMenuOverlay::getLibrarySize(int library) const
+{
+    if (userPresets == nullptr)
+        return 0;
+    return library == userLibrary ? userPresets->getNumPresets()
+                                  : userPresets->getPack(library - firstPackLibrary).getNumEntries();
+}
+
+juce::String PresetMenuOverlay::getLibraryPresetName(int library, int presetIndex) const
+{
+    if (userPresets == nullptr)
+        return {};
+    return library == userLibrary ? userPresets->getName(presetIndex)
+                                  : userPresets->getPack(library - firstPackLibrary).getName(presetIndex);
+}
+
+void PresetMenuOverlay::rebuildLibrarySearch()
+{
+    juce::StringArray documents;
+    librarySearchDocuments.clear();
+
+    if (userPresets != nullptr)
+    {
+        for (int i = 0; i < userPresets->getNumPresets(); ++i)
+        {
+            documents.add(userPresets->getName(i) + " " + userPresets->getCategory(i) + " " + userPresets->getTags(i));
+            librarySearchDocuments.push_back({ userLibrary, i });
+        }
+
+        for (int p = 0; p < userPresets->getNumPacks(); ++p)
+        {
+            const auto& pack = userPresets->getPack(p);
+            for (int i = 0; i < pack.getNumEntries(); ++i)
+            {
+                documents.add(pack.getName(i) + " " + pack.getCategory(i) + " " + pack.getTags(i) + " " + userPresets->getPackName(p));
+                librarySearchDocuments.push_back({ firstPackLibrary + p, i });
+            }
+        }
+    }
+
+    librarySearchIndex.build(documents);
+}
+
+void PresetMenuOverlay::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    // Store indices are only valid until its change message: re-index, then
+    // refresh whatever list is showing without moving the user out of it
+    rebuildLibrarySearch();
+
+    if (isSearching())
+    {
+        setSearchQuery(searchQuery);
+        return;
+    }
+
+    if (getCurrentLibrary() >= getNumLibraries())
+    {
+        showList(-1);
+        return;
+    }
+
+    rowCache.clear();
+    updateScrollLimits();
+    repaint();
+}
+
+void PresetMenuOverlay::showList(int category)
+{
+    currentCategory = category;
+    rowCache.clear();
+    updateScrollLimits();
+    scroll.setPosition(0.0);
+    scrollOffsetRef = 0.0;
+    repaint();
+}
+
+int PresetMenuOverlay::getNumRows() const noexcept
+{
+    if (isSearching())
+        return (int) searchResults.size();
+    if (currentCategory < 0)
+        return getNumCategories() + getNumLibraries();
+    if (const auto library = getCurrentLibrary(); library >= 0)
+        return getLibrarySize(library);
+    return catalog != nullptr ? catalog->getCategory(currentCategory).numPresets : 0;
+}
+
+juce::String PresetMenuOverlay::getRowText(int row) const
+{
+    if (currentCategory < 0 && !isSearching())
+        return row < getNumCategories() ? catalog->getCategory(row).name : getLibraryName(row - getNumCategories());
+
+    const auto preset = getRowPreset(row);
+    if (preset.library != factoryLibrary)
+        return getLibraryPresetName(preset.library, preset.index);
+    return isSearching() ? catalog->getPreset(preset.index).displayName : catalog->getPreset(preset.index).name;
+}
+
+PresetMenuOverlay::PresetRef PresetMenuOverlay::getRowPreset(int row) const
+{
+    if (isSearching())
+        return searchResults[(size_t) row];
+    if (currentCategory < 0)
+        return {};
+    if (const auto library = getCurrentLibrary(); library >= 0)
+        return { library, row };
+    return { factoryLibrary, catalog->getCategory(currentCategory).firstPreset + row };
+}
+
+int PresetMenuOverlay::getRowPresetIndex(int row) const
+{
+    const auto preset = getRowPreset(row);
+    return preset.library == factoryLibrary ? preset.index : -1;
+}
+
+void PresetMenuOverlay::activateRow(int row)
+{
+    const auto preset = getRowPreset(row);
+    if (preset.index < 0)
+    {
+        showList(row);
+        return;
+    }
+
+    if (preset.library != factoryLibrary)
+    {
+        if (onLibraryPresetSelected)
+            onLibraryPresetSelected(preset.library, preset.index);
+    }
+    else if (onPresetSelected)
+    {
+        const auto& factoryPreset = catalog->getPreset(preset.index);
+        onPresetSelected(factoryPreset.category, factoryPreset.indexInCategory);
+    }
+
+    if (onClosed)
+        onClosed();
+}
+
+int PresetMenuOverlay::getRowAt(juce::Point<float> menuRefPosition) const
+{
+    if (menuRefPosition.x < rowXRef || menuRefPosition.x >= rowXRef + rowWidthRef
+        || menuRefPosition.y < firstRowYRef || menuRefPosition.y >= firstRowYRef + getListHeightRef())
+        return -1;
+
+    const auto offset = menuRefPosition.y - firstRowYRef + scrollOffsetRef;
+    const int row = (int) (offset / rowPitchRef);
+    if (offset - row * rowPitchRef >= rowHeightRef || row >= getNumRows())
+        return -1;
+
+    return row;
+}
+
+float PresetMenuOverlay::getListHeightRef() const
+{
+    return (float) (getCurrentMenuRectRef().getHeight() - firstRowYRef - 4);
+}
+
+void PresetMenuOverlay::updateScrollLimits()
+{
+    const auto contentHeight = (double) juce::jmax(0, getNumRows() * rowPitchRef - (rowPitchRef - rowHeightRef));
+    scroll.setLimits({ 0.0, juce::jmax(0.0, contentHeight - getListHeightRef()) });
+}
+
+void PresetMenuOverlay::positionChanged(ScrollPosition&, double newPosition)
+{
+    scrollOffsetRef = newPosition;
+    repaint();
 }
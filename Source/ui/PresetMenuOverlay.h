@@ -1,17 +1,38 @@
 #pragma once
 
-#include <array>
 #include <functional>
+#include <map>
 #include <vector>
 #include <juce_gui_basics/juce_gui_basics.h>
 
-class PresetMenuOverlay : public juce::Component
+#include "../presets/PresetCatalog.h"
+#include "../presets/PresetSearchIndex.h"
+#include "../presets/UserPresetStore.h"
+
+// Category → preset menu drawn over the screen area. Lists are virtualised:
+// only rows inside the visible window are drawn, each from a cached image,
+// and the list scrolls with momentum (drag or wheel), so a category of ten
+// presets and one of ten thousand open and scroll at the same cost.
+//
+// After the factory categories, the category list shows the user's libraries
+// (the UserPresetStore's saved presets, then one list per imported pack);
+// search covers those too.
+class PresetMenuOverlay : public juce::Component,
+                          private juce::AnimatedPosition<juce::AnimatedPositionBehaviours::ContinuousWithMomentum>::Listener,
+                          private juce::ChangeListener
 {
 public:
     using PresetSelected = std::function<void(int categoryIndex, int presetIndex)>;
     using Closed = std::function<void()>;
+    using PresetAuditioned = std::function<void(int presetIndex)>; // flat index, or -1 to stop
+    using LibraryPresetSelected = std::function<void(int library, int presetIndex)>;
+
+    // Library numbers passed to LibraryPresetSelected
+    static constexpr int userLibrary = 0;      // UserPresetStore::getName(presetIndex) etc.
+    static constexpr int firstPackLibrary = 1; // pack p is firstPackLibrary + p: UserPresetStore::getPack(p)
 
     PresetMenuOverlay();
+    ~PresetMenuOverlay() override;
 
     void setMenuImages(const juce::Image* categories,
                        const juce::Image* classic,
@@ -20,19 +41,72 @@ public:
                        const juce::Image* bass,
                        const juce::Image* drums,
                        const juce::Image* vocals);
-    void setPresetLibrary(const juce::StringArray& flattenedChoices);
+    // The catalog must outlive the overlay (it is owned by the processor)
+    void setPresetLibrary(const PresetCatalog& catalog);
+
+    // The store must outlive the overlay (it is owned by the processor)
+    void setUserPresets(UserPresetStore& store);
 
     void setCallbacks(PresetSelected onPresetSelectedIn, Closed onClosedIn);
+    void setLibraryCallback(LibraryPresetSelected onLibraryPresetSelectedIn);
+
+    // Preset rows get a play/stop button at their right edge that previews the
+    // preset without selecting it. The owner reports what is playing.
+    void setAuditionCallback(PresetAuditioned onPresetAuditionedIn);
+    void setAuditioningPreset(int presetIndex);
     void openCategories();
 
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
     void mouseUp(const juce::MouseEvent& event) override;
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
     bool keyPressed(const juce::KeyPress& key) override;
 
 private:
+    using ScrollPosition = juce::AnimatedPosition<juce::AnimatedPositionBehaviours::ContinuousWithMomentum>;
+
+    // A preset in the factory catalog (flat index) or in a user library
+    static constexpr int factoryLibrary = -1;
+    struct PresetRef
+    {
+        int library = factoryLibrary;
+        int index = -1;
+    };
+
     juce::Rectangle<int> scaleRect(const juce::Rectangle<int>& ref) const;
     juce::Rectangle<int> getCurrentMenuRectRef() const;
+    float getMenuScale() const;
+    juce::Point<float> toMenuRef(juce::Point<int> position) const;
+
+    void setSearchQuery(const juce::String& newQuery);
+    bool isSearching() const noexcept { return searchQuery.isNotEmpty(); }
+    int getNumCategories() const noexcept { return catalog != nullptr ? catalog->getNumCategories() : 0; }
+
+    // User libraries follow the factory categories in the category list
+    int getNumLibraries() const noexcept { return userPresets != nullptr ? firstPackLibrary + userPresets->getNumPacks() : 0; }
+    int getCurrentLibrary() const noexcept { return currentCategory >= getNumCategories() ? currentCategory - getNumCategories() : -1; }
+    juce::String getLibraryName(int library) const;
+    int getLibrarySize(int library) const;
+    juce::String getLibraryPresetName(int library, int presetIndex) const;
+
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void rebuildLibrarySearch();
+
+    // The list currently shown: categories, one category's or library's presets, or search results
+    void showList(int category);
+    int getNumRows() const noexcept;
+    juce::String getRowText(int row) const;
+    void activateRow(int row);
+    int getRowAt(juce::Point<float> menuRefPosition) const;
+    PresetRef getRowPreset(int row) const; // index -1 on the category list
+    int getRowPresetIndex(int row) const; // flat factory preset index, or -1
+    float getListHeightRef() const;
+    void updateScrollLimits();
+    void positionChanged(ScrollPosition&, double newPosition) override;
+
+    const juce::Image& getRowImage(int row, juce::Rectangle<int> scaledRowBounds);
 
     // TODO: adjust these reference bounds to exactly match your design placement.
     static constexpr int designW = 3366;
@@ -40,15 +114,42 @@ private:
     const juce::Rectangle<int> categoriesMenuRef { 2365, 580, 637, 348 };
     const juce::Rectangle<int> presetsMenuRef    { 2365, 580, 637, 543 };
 
-    // TODO: adjust row hitboxes as needed against your final PNGs.
-    std::array<juce::Rectangle<int>, 6> categoryRowRectsRef {};
-    std::array<juce::Rectangle<int>, 10> presetRowRectsRef {};
+    // Row geometry inside the menu, in design px; the list area starts at firstRowYRef
+    static constexpr int rowXRef = 24;
+    static constexpr int firstRowYRef = 27;
+    static constexpr int rowWidthRef = 585;
+    static constexpr int rowHeightRef = 43;
+    static constexpr int rowPitchRef = 49;
+    static constexpr int auditionButtonWidthRef = 43;
     juce::Rectangle<int> backRectRef { 24, 0, 190, 27 };
 
-    juce::StringArray categoryNames;
-    std::vector<juce::StringArray> presetsByCategory;
+    const PresetCatalog* catalog = nullptr;
+    UserPresetStore* userPresets = nullptr;
+
+    // As-you-type search across every category and library. Library presets
+    // get their own index (name, category and tags), rebuilt when the store changes.
+    juce::String searchQuery;
+    std::vector<PresetRef> searchResults; // library matches, then factory, best first
+    PresetSearchIndex librarySearchIndex;
+    std::vector<PresetRef> librarySearchDocuments;
     int currentCategory = -1;
 
+    // Kinetic scrolling; the position is the list offset in design px
+    ScrollPosition scroll;
+    double scrollOffsetRef = 0.0;
+    bool isDraggingList = false;
+    static constexpr int dragThresholdPx = 4;
+
+    // Rendered rows of the current list, keyed by row index. Dropped when the
+    // list or the scale changes; trimmed to the rows around the visible window.
+    std::map<int, juce::Image> rowCache;
+    int rowCacheWidth = 0;
+    static constexpr int maxCachedRows = 64;
+
+    int auditioningPreset = -1;
+
     PresetSelected onPresetSelected;
+    LibraryPresetSelected onLibraryPresetSelected;
     Closed onClosed;
+    PresetAuditioned onPresetAuditioned;
 };
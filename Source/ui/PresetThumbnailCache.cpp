@@ -0,0 +1,190 @@
+#include "PresetThumbnailCache.h"
+
+#include <algorithm>
+
+#include "../presets/AtomicFileWrite.h"
+
+namespace
+{
+// Bump when the stored format changes, so old cache files are never matched
+constexpr int cacheFormatVersion = 2;
+} // namespace
+
+class PresetThumbnailCache::LoadJob : public juce::ThreadPoolJob
+{
+public:
+    LoadJob(PresetThumbnailCache& ownerIn, Request requestIn)
+        : juce::ThreadPoolJob("Preset thumbnail"), owner(ownerIn), request(requestIn)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto image = owner.load(request);
+        {
+            const juce::ScopedLock sl(owner.finishedLock);
+            owner.finished.emplace_back(request, std::move(image));
+        }
+        owner.triggerAsyncUpdate();
+        return jobHasFinished;
+    }
+
+private:
+    PresetThumbnailCache& owner;
+    const Request request;
+};
+
+PresetThumbnailCache::PresetThumbnailCache(const PresetCatalog& catalogIn, ThumbnailReady onThumbnailReadyIn)
+    : catalog(catalogIn),
+      onThumbnailReady(std::move(onThumbnailReadyIn)),
+      cacheDirectory(getDefaultCacheDirectory())
+{
+}
+
+PresetThumbnailCache::~PresetThumbnailCache()
+{
+    pool.removeAllJobs(true, 5000);
+    cancelPendingUpdate();
+}
+
+juce::File PresetThumbnailCache::getDefaultCacheDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("3 Voice Unison Mod")
+        .getChildFile("Thumbnail Cache");
+}
+
+juce::Image PresetThumbnailCache::getThumbnail(int presetIndex, juce::Rectangle<int> size)
+{
+    if (!juce::isPositiveAndBelow(presetIndex, catalog.getNumPresets()) || size.isEmpty())
+        return {};
+
+    auto& thumbnail = thumbnails[presetIndex];
+    const bool sizeMatches = thumbnail.width == size.getWidth() && thumbnail.height == size.getHeight();
+
+    if (!sizeMatches && !thumbnail.pending)
+    {
+        // Keeps showing the old size until the new one arrives
+        thumbnail.pending = true;
+        pool.addJob(new LoadJob(*this, { presetIndex, size.getWidth(), size.getHeight() }), true);
+    }
+
+    return thumbnail.image;
+}
+
+void PresetThumbnailCache::handleAsyncUpdate()
+{
+    std::vector<std::pair<Request, juce::Image>> results;
+    {
+        const juce::ScopedLock sl(finishedLock);
+        results.swap(finished);
+    }
+
+    for (auto& [request, image] : results)
+    {
+        auto& thumbnail = thumbnails[request.presetIndex];
+        thumbnail.pending = false;
+        thumbnail.width = request.width;
+        thumbnail.height = request.height;
+        thumbnail.image = std::move(image);
+
+        if (thumbnail.image.isValid() && onThumbnailReady)
+            onThumbnailReady(request.presetIndex);
+    }
+}
+
+juce::Image PresetThumbnailCache::load(const Request& request)
+{
+    // Loader thread (the pool has one), so previewFiles needs no lock
+    if (!previewFilesFound)
+    {
+        previewFiles = catalog.findPreviewImages();
+        previewFilesFound = true;
+    }
+
+    if ((size_t) request.presetIndex >= previewFiles.size())
+        return {};
+
+    const auto& source = previewFiles[(size_t) request.presetIndex];
+    if (!source.existsAsFile())
+        return {};
+
+    const auto cacheKey = source.getFullPathName() + "|" + juce::String(source.getLastModificationTime().toMilliseconds())
+                        + "|" + juce::String(source.getSize()) + "|" + juce::String(request.width) + "x" + juce::String(request.height)
+                        + "|" + juce::String(cacheFormatVersion);
+    const auto cacheName = juce::String::toHexString(cacheKey.hashCode64());
+
+    // The extension depends on the source, which is not decoded yet
+    for (const auto* extension : { ".png", ".jpg" })
+    {
+        const auto cacheFile = cacheDirectory.getChildFile(cacheName + extension);
+        if (cacheFile.existsAsFile())
+        {
+            if (auto cached = juce::ImageFileFormat::loadFrom(cacheFile); cached.isValid())
+            {
+                // The modification time is the last use, for trimCacheDirectory()
+                cacheFile.setLastModificationTime(juce::Time::getCurrentTime());
+                return cached;
+            }
+        }
+    }
+
+    const auto full = juce::ImageFileFormat::loadFrom(source);
+    if (!full.isValid())
+        return {};
+
+    // Fit inside the requested size, keeping the aspect ratio
+    const auto scale = juce::jmin(1.0f, juce::jmin(request.width / (float) full.getWidth(), request.height / (float) full.getHeight()));
+    const auto thumbnail = full.rescaled(juce::jmax(1, juce::roundToInt(full.getWidth() * scale)),
+                                         juce::jmax(1, juce::roundToInt(full.getHeight() * scale)),
+                                         juce::Graphics::highResamplingQuality);
+
+    // JPEG would flatten transparent areas to black
+    juce::PNGImageFormat png;
+    juce::JPEGImageFormat jpeg;
+    jpeg.setQuality(0.85f);
+    const bool keepAlpha = thumbnail.hasAlphaChannel();
+    auto& format = keepAlpha ? static_cast<juce::ImageFileFormat&>(png) : jpeg;
+
+    const auto cacheFile = cacheDirectory.getChildFile(cacheName + (keepAlpha ? ".png" : ".jpg"));
+    const bool written = AtomicFileWrite::write(cacheFile, [&thumbnail, &format](const juce::File& temp)
+    {
+        juce::FileOutputStream stream(temp);
+        return stream.openedOk() && format.writeImageToStream(thumbnail, stream);
+    });
+
+    if (written)
+        trimCacheDirectory();
+
+    return thumbnail;
+}
+
+void PresetThumbnailCache::trimCacheDirectory() const
+{
+    // Loader thread. Other instances may trim the same folder; a file already
+    // gone just fails to delete.
+    std::vector<std::pair<juce::Time, juce::File>> files;
+    juce::int64 totalBytes = 0;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(cacheDirectory, false, "*", juce::File::findFiles))
+    {
+        files.emplace_back(entry.getModificationTime(), entry.getFile());
+        totalBytes += entry.getFileSize();
+    }
+
+    if (totalBytes <= maxCacheBytes)
+        return;
+
+    // Oldest first, down to three quarters of the cap so the next writes do not trim again
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [time, file] : files)
+    {
+        if (totalBytes <= maxCacheBytes / 4 * 3)
+            break;
+
+        const auto size = file.getSize();
+        if (file.deleteFile())
+            totalBytes -= size;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+
+#include "../presets/PresetCatalog.h"
+
+// Preset preview images, decoded only when asked for and at the size they are
+// drawn.
+//
+// getThumbnail() returns at once: either the thumbnail, or an invalid image
+// while a background thread finds the preset's image, decodes it, scales it
+// down once and stores it in the thumbnail cache folder (JPEG, or PNG when the
+// source has an alpha channel). Later requests, in this editor or the next,
+// load that file instead of the full image. Cache file names include the
+// source's path, time, size and the thumbnail size, so a replaced image or a
+// new size is never served stale. Every write trims the folder back under
+// maxCacheBytes, dropping the least recently used files first.
+//
+// Message thread only; onThumbnailReady is called on the message thread.
+class PresetThumbnailCache : private juce::AsyncUpdater
+{
+public:
+    using ThumbnailReady = std::function<void(int presetIndex)>;
+
+    // The catalog must outlive the cache (it is owned by the processor)
+    PresetThumbnailCache(const PresetCatalog& catalog, ThumbnailReady onThumbnailReady);
+    ~PresetThumbnailCache() override;
+
+    static juce::File getDefaultCacheDirectory();
+
+    juce::Image getThumbnail(int presetIndex, juce::Rectangle<int> size);
+
+private:
+    struct Request
+    {
+        int presetIndex = -1;
+        int width = 0, height = 0;
+    };
+
+    class LoadJob;
+
+    void handleAsyncUpdate() override;
+    juce::Image load(const Request& request);
+    void trimCacheDirectory() const;
+
+    static constexpr juce::int64 maxCacheBytes = 64 * 1024 * 1024;
+
+    const PresetCatalog& catalog;
+    const ThumbnailReady onThumbnailReady;
+    const juce::File cacheDirectory;
+
+    // Message thread
+    struct Thumbnail
+    {
+        juce::Image image;
+        int width = 0, height = 0;
+        bool pending = false;
+    };
+    std::map<int, Thumbnail> thumbnails;
+
+    // Loader thread: preview files, found on first use
+    std::vector<juce::File> previewFiles;
+    bool previewFilesFound = false;
+
+    juce::CriticalSection finishedLock;
+    std::vector<std::pair<Request, juce::Image>> finished;
+
+    juce::ThreadPool pool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetThumbnailCache)
+};
@@ -0,0 +1,183 @@
+# Compiles the factory preset XML into a C++ header of constexpr tables.
+#
+#   cmake -DPRESET_DIR=<Presets> -DPRESET_LIST=<FactoryPresetList.h>
+#         -DOUTPUT=<FactoryPresetData.h> -P CompileFactoryPresets.cmake
+#
+# Two kinds of source are read from PRESET_DIR:
+#   ImageDerived.xml  <PRESET key="..."> elements, each with
+#                     <PARAM id="..." value="..."/> children; matched to a
+#                     list entry through PresetCatalog::makeKey(category, name).
+#                     Not part of the source tree: it is generated from the
+#                     preset artwork and dropped in by the release build.
+#   <name>.xml        one preset per file, <PARAM> children of the root; used
+#                     for a list entry with no ImageDerived.xml key whose name
+#                     matches the file name (the "Basics" presets).
+#
+# The tables are indexed like the catalog: entry i is the preset at position i
+# in PRESET_LIST. Parameter IDs are resolved to ParamIds::Index at compile
+# time (see ParamIds::find), so the plugin never reads the XML at runtime.
+# Entries found in neither source are marked missing and resolved at runtime.
+
+if(NOT PRESET_DIR OR NOT PRESET_LIST OR NOT OUTPUT)
+    message(FATAL_ERROR "CompileFactoryPresets: PRESET_DIR, PRESET_LIST and OUTPUT are required")
+endif()
+
+function(escape_string input out_var)
+    string(REPLACE "\\" "\\\\" escaped "${input}")
+    string(REPLACE "\"" "\\\"" escaped "${escaped}")
+    set(${out_var} "${escaped}" PARENT_SCOPE)
+endfunction()
+
+# PresetCatalog::makeKey for the plain names FactoryPresetList.h holds
+function(make_key category name out_var)
+    if(category MATCHES "^Keys[ _/]*Synth$")
+        set(category "Keys / Synth")
+    endif()
+    string(TOLOWER "${category}|${name}" key)
+    string(REGEX REPLACE "[ .,_'!+()/\\\\-]" "" key "${key}")
+    set(${out_var} "${key}" PARENT_SCOPE)
+endfunction()
+
+# The <PRESET>, </PRESET> and <PARAM> tags of an XML file, in order
+function(read_preset_tags file out_var)
+    file(READ "${file}" content)
+    # Semicolons would split the token list
+    string(REPLACE ";" "" content "${content}")
+    string(REGEX MATCHALL "<(PRESET|/PRESET|PARAM)[^>]*>" tags "${content}")
+    set(${out_var} "${tags}" PARENT_SCOPE)
+endfunction()
+
+# Table line for one <PARAM> tag, or "" (with a warning) if it is malformed
+function(make_param_line source tag out_var)
+    string(REGEX MATCH "id=\"([^\"]*)\"" id_match "${tag}")
+    set(id "${CMAKE_MATCH_1}")
+    string(REGEX MATCH "value=\"([^\"]*)\"" value_match "${tag}")
+    string(STRIP "${CMAKE_MATCH_1}" value)
+
+    if(id STREQUAL "" OR NOT value MATCHES "^[-+]?[0-9]+(\\.[0-9]*)?([eE][-+]?[0-9]+)?$")
+        message(WARNING "CompileFactoryPresets: skipping malformed PARAM in ${source}: ${tag}")
+        set(${out_var} "" PARENT_SCOPE)
+        return()
+    endif()
+
+    if(NOT value MATCHES "[.eE]")
+        set(value "${value}.0")
+    endif()
+    escape_string("${id}" id)
+    set(${out_var} "    { ParamIds::find(\"${id}\"), ${value}f },\n" PARENT_SCOPE)
+endfunction()
+
+# ImageDerived.xml: parameter lines per preset key, stored under an MD5 of the
+# key so any key makes a valid variable name
+set(image_derived_file "${PRESET_DIR}/ImageDerived.xml")
+if(EXISTS "${image_derived_file}")
+    read_preset_tags("${image_derived_file}" tags)
+
+    set(in_preset FALSE)
+    foreach(tag IN LISTS tags)
+        if(tag MATCHES "^<PRESET")
+            string(REGEX MATCH "key=\"([^\"]*)\"" key_match "${tag}")
+            string(MD5 preset_hash "${CMAKE_MATCH_1}")
+            set(preset_lines_${preset_hash} "")
+            set(preset_count_${preset_hash} 0)
+            set(in_preset TRUE)
+        elseif(tag MATCHES "^</PRESET")
+            set(in_preset FALSE)
+        elseif(in_preset)
+            make_param_line("${image_derived_file}" "${tag}" param_line)
+            if(NOT param_line STREQUAL "")
+                string(APPEND preset_lines_${preset_hash} "${param_line}")
+                math(EXPR preset_count_${preset_hash} "${preset_count_${preset_hash}} + 1")
+            endif()
+        endif()
+    endforeach()
+endif()
+
+# One table entry per catalog preset, in catalog order
+set(param_lines "")
+set(preset_lines "")
+set(num_params 0)
+set(num_presets 0)
+set(num_found 0)
+set(sources "")
+
+file(STRINGS "${PRESET_LIST}" list_lines REGEX "^THREEVOICES_PRESET\\(")
+foreach(line IN LISTS list_lines)
+    if(NOT line MATCHES "^THREEVOICES_PRESET\\(\"([^\"]*)\", *\"([^\"]*)\"\\)")
+        message(FATAL_ERROR "CompileFactoryPresets: cannot read ${PRESET_LIST} line: ${line}")
+    endif()
+    set(category "${CMAKE_MATCH_1}")
+    set(name "${CMAKE_MATCH_2}")
+    make_key("${category}" "${name}" key)
+    string(MD5 preset_hash "${key}")
+
+    # A loose file fills in a preset ImageDerived.xml does not list
+    set(loose_file "${PRESET_DIR}/${name}.xml")
+    if(NOT DEFINED preset_count_${preset_hash} AND EXISTS "${loose_file}")
+        read_preset_tags("${loose_file}" tags)
+        set(preset_lines_${preset_hash} "")
+        set(preset_count_${preset_hash} 0)
+        foreach(tag IN LISTS tags)
+            if(tag MATCHES "^<PARAM")
+                make_param_line("${loose_file}" "${tag}" param_line)
+                if(NOT param_line STREQUAL "")
+                    string(APPEND preset_lines_${preset_hash} "${param_line}")
+                    math(EXPR preset_count_${preset_hash} "${preset_count_${preset_hash}} + 1")
+                endif()
+            endif()
+        endforeach()
+        get_filename_component(loose_file_name "${loose_file}" NAME)
+        list(APPEND sources "${loose_file_name}")
+    endif()
+
+    if(DEFINED preset_count_${preset_hash})
+        string(APPEND param_lines "${preset_lines_${preset_hash}}")
+        string(APPEND preset_lines "    { ${num_params}, ${preset_count_${preset_hash}}, true },  // ${category} - ${name}\n")
+        math(EXPR num_params "${num_params} + ${preset_count_${preset_hash}}")
+        math(EXPR num_found "${num_found} + 1")
+    else()
+        if(EXISTS "${image_derived_file}")
+            message(WARNING "CompileFactoryPresets: no PRESET with key \"${key}\" for ${category} - ${name}")
+        endif()
+        string(APPEND preset_lines "    { 0, 0, false },  // ${category} - ${name}\n")
+    endif()
+    math(EXPR num_presets "${num_presets} + 1")
+endforeach()
+
+if(EXISTS "${image_derived_file}")
+    list(INSERT sources 0 "ImageDerived.xml")
+endif()
+if(sources STREQUAL "")
+    set(sources "no preset files")
+endif()
+list(JOIN sources ", " source_names)
+message(STATUS "CompileFactoryPresets: ${num_found} of ${num_presets} factory presets compiled")
+
+set(available false)
+if(num_found GREATER 0)
+    set(available true)
+endif()
+
+set(header "// Generated by cmake/CompileFactoryPresets.cmake from ${source_names}. Do not edit.\n")
+string(APPEND header "// Included from Source/state/FactoryPresets.h only.\n\n")
+string(APPEND header "#pragma once\n\n")
+string(APPEND header "namespace FactoryPresetData\n{\n")
+string(APPEND header "inline constexpr bool available = ${available};\n\n")
+
+if(num_params EQUAL 0)
+    string(APPEND header "inline constexpr std::array<FactoryPresets::Param, 0> params {};\n\n")
+else()
+    string(APPEND header "inline constexpr std::array<FactoryPresets::Param, ${num_params}> params {{\n${param_lines}}};\n\n")
+endif()
+
+string(APPEND header "// Indexed by catalog position (the presetChoice value)\n")
+if(num_presets EQUAL 0 OR NOT available)
+    string(APPEND header "inline constexpr std::array<FactoryPresets::Preset, 0> presets {};\n")
+else()
+    string(APPEND header "inline constexpr std::array<FactoryPresets::Preset, ${num_presets}> presets {{\n${preset_lines}}};\n")
+endif()
+
+string(APPEND header "} // namespace FactoryPresetData\n")
+
+# Leave the file untouched when nothing changed, so dependants do not rebuild
+file(CONFIGURE OUTPUT "${OUTPUT}" CONTENT "${header}" @ONLY)
@@ -0,0 +1,171 @@
+// Save -> load round trip and timing for BinaryState.
+//
+// Runs as a ctest (see CMakeLists.txt); exits non-zero on the first failure.
+
+#include <cstdio>
+
+#include <juce_core/juce_core.h>
+
+#include "../Source/state/BinaryState.h"
+#include "../Source/state/ParameterIds.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// The XML state BinaryState replaced: the APVTS tree as XML, wrapped the way
+// AudioProcessor::copyXmlToBinary / getXmlFromBinary do (magic, length, text).
+// Reimplemented on juce_core so the check does not need the plugin framework.
+constexpr juce::uint32 legacyXmlMagic = 0x21324356;
+
+void writeLegacyXml(const ParameterValues& values, juce::MemoryBlock& destData)
+{
+    juce::XmlElement xml("Parameters");
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        auto* param = xml.createNewChildElement("PARAM");
+        param->setAttribute("id", ParamIds::ids[i]);
+        param->setAttribute("value", values[i]);
+    }
+
+    destData.reset();
+    {
+        juce::MemoryOutputStream out(destData, false);
+        out.writeInt((int) legacyXmlMagic);
+        out.writeInt(0);
+        xml.writeTo(out, juce::XmlElement::TextFormat().singleLine());
+        out.writeByte(0);
+    }
+    static_cast<juce::uint32*>(destData.getData())[1] = juce::ByteOrder::swapIfBigEndian((juce::uint32) destData.getSize() - 9);
+}
+
+bool readLegacyXml(const juce::MemoryBlock& data, ParameterValues& values)
+{
+    if (data.getSize() <= 8 || juce::ByteOrder::littleEndianInt(data.getData()) != legacyXmlMagic)
+        return false;
+
+    const auto stringLength = (int) juce::ByteOrder::littleEndianInt(static_cast<const char*>(data.getData()) + 4);
+    if (stringLength <= 0 || (size_t) stringLength > data.getSize() - 8)
+        return false;
+
+    const auto xml = juce::parseXML(juce::String::fromUTF8(static_cast<const char*>(data.getData()) + 8, stringLength));
+    if (xml == nullptr)
+        return false;
+
+    for (auto* param : xml->getChildWithTagNameIterator("PARAM"))
+    {
+        const auto index = ParamIds::find(param->getStringAttribute("id").toRawUTF8());
+        if (index >= 0)
+            values[(size_t) index] = (float) param->getDoubleAttribute("value");
+    }
+    return true;
+}
+
+template <typename RoundTrip>
+double microsecondsPerRoundTrip(int iterations, RoundTrip&& roundTrip)
+{
+    const auto start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < iterations; ++i)
+        roundTrip();
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    return seconds * 1.0e6 / iterations;
+}
+
+ParameterValues makeValues()
+{
+    ParameterValues values {};
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = (float) i * 0.37f - 4.0f;
+    return values;
+}
+} // namespace
+
+int main()
+{
+    const auto saved = makeValues();
+
+    juce::MemoryBlock blob;
+    BinaryState::write(saved, blob);
+
+    check(blob.getSize() == 8 + saved.size() * sizeof(float) + 2 + 4, "blob holds header, values, property count and CRC");
+    check(BinaryState::hasBinaryStateHeader(blob.getData(), blob.getSize()), "blob starts with the header");
+
+    ParameterValues loaded {};
+    check(BinaryState::read(blob.getData(), blob.getSize(), loaded), "blob reads back");
+    check(loaded == saved, "values survive the round trip");
+
+    // Rewriting into a block that already holds data must not keep stale bytes
+    juce::MemoryBlock reused(4096, true);
+    BinaryState::write(saved, reused);
+    check(reused == blob, "writing into a used block gives the same blob");
+
+    auto corrupt = blob;
+    static_cast<char*>(corrupt.getData())[10] ^= 0x40;
+    auto untouched = makeValues();
+    check(!BinaryState::read(corrupt.getData(), corrupt.getSize(), untouched), "corrupt blob is rejected");
+    check(untouched == saved, "a rejected blob leaves the values alone");
+
+    check(!BinaryState::read(blob.getData(), blob.getSize() - 1, loaded), "truncated blob is rejected");
+
+    juce::StringPairArray savedProperties;
+    savedProperties.set("cabinetImpulse", "/Users/someone/IRs/V30 4x12.wav");
+    juce::MemoryBlock withProperties;
+    BinaryState::write(saved, withProperties, savedProperties);
+
+    juce::StringPairArray loadedProperties;
+    check(BinaryState::read(withProperties.getData(), withProperties.getSize(), loaded, &loadedProperties),
+          "blob with properties reads back");
+    check(loaded == saved && loadedProperties == savedProperties, "properties survive the round trip");
+
+    // A version 1 blob (no property section) still loads
+    juce::MemoryBlock legacy;
+    {
+        juce::MemoryOutputStream out(legacy, false);
+        out.write("3VUS", 4);
+        out.writeShort(1);
+        out.writeShort((short) saved.size());
+        for (const auto value : saved)
+            out.writeFloat(value);
+        out.writeInt((int) BinaryState::crc32(out.getData(), out.getDataSize()));
+    }
+    loaded = {};
+    check(BinaryState::read(legacy.getData(), legacy.getSize(), loaded, &loadedProperties), "version 1 blob reads");
+    check(loaded == saved && loadedProperties.size() == 0, "version 1 blob has values and no properties");
+
+    juce::MemoryBlock legacyXml;
+    writeLegacyXml(saved, legacyXml);
+    loaded = {};
+    check(readLegacyXml(legacyXml, loaded) && loaded == saved, "legacy XML state round trips");
+
+    // Timing against the XML state it replaced
+    constexpr int iterations = 100000;
+    const auto binaryMicros = microsecondsPerRoundTrip(iterations, [&]
+    {
+        BinaryState::write(saved, blob);
+        BinaryState::read(blob.getData(), blob.getSize(), loaded);
+    });
+    const auto xmlMicros = microsecondsPerRoundTrip(iterations / 10, [&]
+    {
+        writeLegacyXml(saved, legacyXml);
+        readLegacyXml(legacyXml, loaded);
+    });
+
+    std::printf("binary save + load: %.3f us per round trip (%d bytes)\n", binaryMicros, (int) blob.getSize());
+    std::printf("XML save + load:    %.3f us per round trip (%d bytes)\n", xmlMicros, (int) legacyXml.getSize());
+    if (binaryMicros > 0.0)
+        std::printf("binary is %.1fx faster\n", xmlMicros / binaryMicros);
+
+    if (failures == 0)
+        std::printf("BinaryState round trip: OK\n");
+
+    return failures == 0 ? 0 : 1;
+}
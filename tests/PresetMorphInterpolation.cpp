@@ -0,0 +1,94 @@
+// Morph position -> parameter values for PresetMorph.
+//
+// Runs as a ctest (see CMakeLists.txt); exits non-zero on the first failure.
+
+#include <cmath>
+#include <cstdio>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "../Source/state/PresetMorph.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+bool near(float a, float b)
+{
+    return std::abs(a - b) <= 1.0e-4f * juce::jmax(1.0f, std::abs(a), std::abs(b));
+}
+
+juce::uint64 bitOf(ParamIds::Index index)
+{
+    return juce::uint64 { 1 } << index;
+}
+} // namespace
+
+int main()
+{
+    ParameterValues a {}, b {};
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = (float) i;
+        b[i] = (float) i * 3.0f + 10.0f;
+    }
+
+    // Same kinds as the processor: the switches are discrete, the gains and
+    // the morph control itself never follow the morph
+    const auto discrete = bitOf(ParamIds::forVoice(0, ParamIds::voiceOn)) | bitOf(ParamIds::cabType);
+    auto morphable = ~juce::uint64 { 0 };
+    for (const auto fixed : { ParamIds::inputGain, ParamIds::outputGain, ParamIds::presetChoice, ParamIds::morph })
+        morphable &= ~bitOf(fixed);
+
+    PresetMorph morph;
+    morph.setParameterKinds(discrete, morphable);
+
+    ParameterValues out {};
+    check(!morph.process(0.5f, out), "nothing is morphed before targets are set");
+
+    morph.setTargets(a, b);
+    check(morph.isEnabled(), "setting targets enables the morph");
+
+    for (const float amount : { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f })
+    {
+        check(morph.process(amount, out), "an enabled morph produces values");
+
+        bool lerped = true, flipped = true;
+        for (int i = 0; i < ParamIds::numParams; ++i)
+        {
+            const auto index = (ParamIds::Index) i;
+            if ((discrete & bitOf(index)) != 0)
+                flipped = flipped && out[(size_t) i] == (amount < 0.5f ? a[(size_t) i] : b[(size_t) i]);
+            else
+                lerped = lerped && near(out[(size_t) i], a[(size_t) i] + (b[(size_t) i] - a[(size_t) i]) * amount);
+        }
+
+        check(lerped, "continuous parameters sit on the line between A and B");
+        check(flipped, "discrete parameters switch from A to B at the halfway point");
+        check(morph.evaluate(amount) == out, "message thread evaluate matches the audio thread");
+    }
+
+    morph.process(-1.0f, out);
+    check(out == a, "positions below 0 clamp to A");
+    morph.process(2.0f, out);
+    check(near(out[ParamIds::mix], b[ParamIds::mix]), "positions above 1 clamp to B");
+
+    check(morph.isMorphable(ParamIds::mix) && !morph.isMorphable(ParamIds::morph), "morphable mask is kept");
+
+    morph.disable();
+    check(!morph.process(0.5f, out), "a disabled morph leaves the live parameters alone");
+
+    if (failures == 0)
+        std::printf("PresetMorph interpolation: OK\n");
+
+    return failures == 0 ? 0 : 1;
+}